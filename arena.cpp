@@ -0,0 +1,176 @@
+#include "arena.h"
+#include <algorithm> // For max
+#include <cstdlib>	  // For getenv
+#include <cstring>	  // For strcmp
+#include <cstdint>	  // For uintptr_t
+#include <sys/mman.h> // For mmap and madvise
+#include <unistd.h>	  // For sysconf
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+#ifndef MAP_HUGE_1GB
+#define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+#endif
+
+using namespace std;
+
+// smallest chunk mapped at once, big allocations get a chunk of their own size
+static const size_t ARENA_MIN_CHUNK_BYTES = 64UL << 20;
+static const size_t HUGE_PAGE_2MB = 2UL << 20;
+static const size_t HUGE_PAGE_1GB = 1UL << 30;
+
+static size_t roundUp(size_t value, size_t multiple)
+{
+	return (value + multiple - 1) / multiple * multiple;
+}
+
+Arena::Arena(ArenaPageSize page_size) : page_size_(page_size), bytes_reserved_(0), huge_page_bytes_(0)
+{
+}
+
+Arena::~Arena()
+{
+	release();
+}
+
+/**
+ * @brief Maps a new chunk of at least min_bytes.
+ *
+ * Tries explicit huge pages of the configured size first (they need pages reserved in
+ * /proc/sys/vm/nr_hugepages). If none are available the chunk is mapped with regular
+ * pages, aligned to 2MB and marked with MADV_HUGEPAGE so that the kernel can back it
+ * with transparent huge pages. With ARENA_PAGES_DEFAULT the chunk is marked
+ * MADV_NOHUGEPAGE instead, so it really stays on regular pages even where THP is
+ * enabled system-wide.
+ *
+ * @return false if no memory could be mapped.
+ */
+bool Arena::mapChunk(size_t min_bytes)
+{
+	size_t size = roundUp(max(min_bytes, ARENA_MIN_CHUNK_BYTES), HUGE_PAGE_2MB);
+	void *memory = MAP_FAILED;
+	size_t page_bytes = (size_t)sysconf(_SC_PAGESIZE);
+
+	if (page_size_ == ARENA_PAGES_1GB)
+	{
+		size_t huge_size = roundUp(size, HUGE_PAGE_1GB);
+		memory = mmap(NULL, huge_size, PROT_READ | PROT_WRITE,
+					  MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_HUGE_1GB, -1, 0);
+		if (memory != MAP_FAILED)
+		{
+			size = huge_size;
+			huge_page_bytes_ += size;
+			page_bytes = HUGE_PAGE_1GB;
+		}
+	}
+	if (memory == MAP_FAILED && page_size_ != ARENA_PAGES_DEFAULT)
+	{
+		memory = mmap(NULL, size, PROT_READ | PROT_WRITE,
+					  MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_HUGE_2MB, -1, 0);
+		if (memory != MAP_FAILED)
+		{
+			huge_page_bytes_ += size;
+			page_bytes = HUGE_PAGE_2MB;
+		}
+	}
+	if (memory == MAP_FAILED && page_size_ == ARENA_PAGES_DEFAULT)
+	{
+		memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (memory == MAP_FAILED)
+			return false;
+		madvise(memory, size, MADV_NOHUGEPAGE);
+	}
+	if (memory == MAP_FAILED)
+	{
+		// over-map by one huge page so the chunk can start on a 2MB boundary
+		char *raw = (char *)mmap(NULL, size + HUGE_PAGE_2MB, PROT_READ | PROT_WRITE,
+								 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (raw == (char *)MAP_FAILED)
+			return false;
+
+		char *aligned = (char *)roundUp((uintptr_t)raw, HUGE_PAGE_2MB);
+		if (aligned > raw)
+			munmap(raw, aligned - raw);
+		if (aligned + size < raw + size + HUGE_PAGE_2MB)
+			munmap(aligned + size, raw + size + HUGE_PAGE_2MB - (aligned + size));
+
+		memory = aligned;
+		madvise(memory, size, MADV_HUGEPAGE);
+	}
+
+	chunks_.push_back({(char *)memory, size, 0, page_bytes});
+	bytes_reserved_ += size;
+	return true;
+}
+
+/**
+ * @brief Returns zero-initialised memory that stays valid until release().
+ *
+ * @param bytes Size of the allocation.
+ * @param alignment Power of two alignment of the returned address.
+ * @return The memory, or NULL if nothing could be mapped.
+ */
+void *Arena::allocate(size_t bytes, size_t alignment)
+{
+	if (chunks_.empty() || roundUp(chunks_.back().used, alignment) + bytes > chunks_.back().size)
+	{
+		if (!mapChunk(bytes + alignment))
+			return NULL;
+	}
+
+	Chunk &chunk = chunks_.back();
+	size_t offset = roundUp(chunk.used, alignment);
+	chunk.used = offset + bytes;
+	return chunk.base + offset;
+}
+
+/**
+ * @brief Returns the page size of the chunk holding an allocation.
+ *
+ * Chunks backed by explicit huge pages only accept ranges aligned to their huge page
+ * size in calls such as mbind; transparent huge pages and regular chunks use the base
+ * page size.
+ *
+ * @return The page size in bytes, the base page size for addresses outside the arena.
+ */
+size_t Arena::pageBytesAt(const void *address) const
+{
+	for (const Chunk &chunk : chunks_)
+	{
+		if ((const char *)address >= chunk.base && (const char *)address < chunk.base + chunk.size)
+			return chunk.page_bytes;
+	}
+	return (size_t)sysconf(_SC_PAGESIZE);
+}
+
+/**
+ * @brief Unmaps every chunk, invalidating all allocations at once.
+ */
+void Arena::release()
+{
+	for (const Chunk &chunk : chunks_)
+		munmap(chunk.base, chunk.size);
+	chunks_.clear();
+	bytes_reserved_ = 0;
+	huge_page_bytes_ = 0;
+}
+
+/**
+ * @brief Reads the arena page size from the BF_ARENA_PAGES environment variable.
+ *
+ * "4k" selects regular pages (without transparent huge pages), "1g" 1GB pages, anything
+ * else 2MB pages. Lets runs with and without huge pages be compared without rebuilding.
+ */
+ArenaPageSize arenaPageSizeFromEnvironment()
+{
+	const char *pages = getenv("BF_ARENA_PAGES");
+	if (pages != NULL && strcmp(pages, "4k") == 0)
+		return ARENA_PAGES_DEFAULT;
+	if (pages != NULL && strcmp(pages, "1g") == 0)
+		return ARENA_PAGES_1GB;
+	return ARENA_PAGES_2MB;
+}
@@ -0,0 +1,67 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <vector>
+
+// page size requested for arena chunks
+enum ArenaPageSize
+{
+	// regular pages only, transparent huge pages are turned off for the chunks
+	ARENA_PAGES_DEFAULT,
+	ARENA_PAGES_2MB,
+	ARENA_PAGES_1GB
+};
+
+// alignment of every arena allocation unless asked otherwise: one cache line, which
+// also covers 512-bit SIMD loads
+const size_t ARENA_DEFAULT_ALIGNMENT = 64;
+
+// Bump allocator for large, long-lived arrays (graph edges, layouts, distances).
+//
+// Memory is mapped in big chunks backed by explicit huge pages when available, falling
+// back to regular pages with transparent huge pages, so random accesses into the arrays
+// need far fewer TLB entries. Allocations are never freed one by one; release() returns
+// every chunk at once.
+class Arena
+{
+public:
+	explicit Arena(ArenaPageSize page_size = ARENA_PAGES_2MB);
+	~Arena();
+
+	void *allocate(size_t bytes, size_t alignment = ARENA_DEFAULT_ALIGNMENT);
+	template <typename T>
+	T *allocateArray(size_t count, size_t alignment = ARENA_DEFAULT_ALIGNMENT)
+	{
+		return (T *)allocate(count * sizeof(T), alignment);
+	}
+
+	void release();
+
+	size_t bytesReserved() const { return bytes_reserved_; }
+	size_t hugePageBytes() const { return huge_page_bytes_; }
+	ArenaPageSize pageSize() const { return page_size_; }
+	size_t pageBytesAt(const void *address) const;
+
+private:
+	struct Chunk
+	{
+		char *base;
+		size_t size;
+		size_t used;
+		// size of the pages the chunk is mapped with, ranges passed to mbind and the
+		// like have to be aligned to it
+		size_t page_bytes;
+	};
+
+	bool mapChunk(size_t min_bytes);
+
+	ArenaPageSize page_size_;
+	std::vector<Chunk> chunks_;
+	size_t bytes_reserved_;
+	size_t huge_page_bytes_;
+};
+
+ArenaPageSize arenaPageSizeFromEnvironment();
+
+#endif // ARENA_H
@@ -0,0 +1,83 @@
+#include "async_solver.h"
+
+using namespace std;
+
+GraphVersion::GraphVersion(int num_threads) : solver(num_threads), version(0)
+{
+	pthread_mutex_init(&mutex, NULL);
+}
+
+GraphVersion::~GraphVersion()
+{
+	pthread_mutex_destroy(&mutex);
+}
+
+/**
+ * @param executor Runs every task, it needs at least two threads for a load to overlap
+ * with queries.
+ * @param num_threads Threads of the solver of every graph version.
+ * @param engine Engine of every graph version.
+ */
+AsyncSolver::AsyncSolver(TaskExecutor *executor, int num_threads, SolverEngine engine)
+	: executor_(executor), num_threads_(num_threads), engine_(engine), versions_loaded_(0)
+{
+}
+
+/**
+ * @brief Loads a graph as a new version and makes it current once it is ready.
+ *
+ * Reading and preprocessing the graph and building the layouts of the engine are two
+ * steps, and the task goes back to the executor in between, so queued queries get a
+ * thread even on a single-threaded executor. Queries keep using the current version
+ * until the new one is complete. If loads overlap, the one started last wins.
+ *
+ * @return SSSP_OK, or the status of Solver::load or Solver::prepareEngine.
+ */
+Task<int> AsyncSolver::load(string input_graph_path)
+{
+	co_await executor_->schedule();
+	shared_ptr<GraphVersion> next = make_shared<GraphVersion>(num_threads_);
+	next->version = ++versions_loaded_;
+	next->solver.setEngine(engine_);
+	int status = next->solver.load(input_graph_path);
+	if (status != SSSP_OK)
+		co_return status;
+
+	co_await executor_->schedule();
+	status = next->solver.prepareEngine();
+	if (status != SSSP_OK)
+		co_return status;
+
+	shared_ptr<GraphVersion> previous = current_.load();
+	while ((previous == NULL || previous->version < next->version) &&
+		   !current_.compare_exchange_weak(previous, next))
+		;
+	co_return SSSP_OK;
+}
+
+/**
+ * @brief Solves from a source on the current graph version.
+ *
+ * Queries on the same version run one after another, each blocking its executor thread
+ * while it waits; a load in progress does not delay them.
+ *
+ * @return The status of Solver::solve (SSSP_ERROR_NO_GRAPH before the first load) and,
+ * unless it is an error, the distances.
+ */
+Task<AsyncSolveResult> AsyncSolver::solve(int source_node_id)
+{
+	co_await executor_->schedule();
+	shared_ptr<GraphVersion> graph = current_.load();
+	AsyncSolveResult result = {SSSP_ERROR_NO_GRAPH, 0, 0, {}};
+	if (graph == NULL)
+		co_return result;
+
+	pthread_mutex_lock(&graph->mutex);
+	result.status = graph->solver.solve(source_node_id);
+	result.graph_version = graph->version;
+	result.rounds = graph->solver.rounds();
+	if (result.status >= 0)
+		result.distances.assign(graph->solver.distances(), graph->solver.distances() + graph->solver.nodeCount());
+	pthread_mutex_unlock(&graph->mutex);
+	co_return result;
+}
@@ -0,0 +1,55 @@
+#ifndef ASYNC_SOLVER_H
+#define ASYNC_SOLVER_H
+
+#include <pthread.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include "sssp_solver.h"
+#include "task_executor.h"
+
+// one loaded and prepared graph, queries on it take turns through its mutex
+struct GraphVersion
+{
+	explicit GraphVersion(int num_threads);
+	~GraphVersion();
+
+	Solver solver;
+	pthread_mutex_t mutex;
+	unsigned long long version;
+};
+
+struct AsyncSolveResult
+{
+	int status;
+	// version of the graph the query was answered on, 0 if none was loaded
+	unsigned long long graph_version;
+	int rounds;
+	std::vector<long> distances;
+};
+
+// Coroutine front end of the solver.
+//
+// Loads, layout building and solves are tasks on a shared TaskExecutor. Every load
+// builds a complete new GraphVersion next to the current one, which keeps answering
+// queries meanwhile, and then replaces it with one atomic store. A query holds on to
+// the version it started on, so a version is released only after its last query.
+class AsyncSolver
+{
+public:
+	AsyncSolver(TaskExecutor *executor, int num_threads, SolverEngine engine);
+
+	Task<int> load(std::string input_graph_path);
+	Task<AsyncSolveResult> solve(int source_node_id);
+	std::shared_ptr<GraphVersion> current() const { return current_.load(); }
+
+private:
+	TaskExecutor *executor_;
+	int num_threads_;
+	SolverEngine engine_;
+	std::atomic<std::shared_ptr<GraphVersion>> current_;
+	std::atomic<unsigned long long> versions_loaded_;
+};
+
+#endif // ASYNC_SOLVER_H
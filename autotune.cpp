@@ -0,0 +1,367 @@
+#include "autotune.h"
+#include "csr.h"
+#include <algorithm> // For max and min
+#include <chrono>	 // For timing the probes
+#include <cstdlib>	 // For malloc
+#include <cstring>	 // For memcpy
+#include <fstream>	 // For profile files
+#include <sstream>	 // For parsing profile lines
+#include <stdexcept> // For the exceptions of stoi and stod
+
+using namespace std;
+
+// sampled sources for the diameter estimate and for every probe
+static const int TUNE_SAMPLED_SOURCES = 3;
+
+// fewest edges per thread for which a thread count is worth probing
+static const int TUNE_MIN_EDGES_PER_THREAD = 50000;
+
+// the spmv engine needs one round per edge of the longest shortest path, so it is only
+// probed on graphs whose estimated diameter stays below this
+static const int TUNE_SPMV_MAX_DIAMETER = 1000;
+
+// larger graphs are probed on a sample of about this many edges around the sources
+static const int TUNE_PROBE_MAX_EDGES = 1 << 21;
+
+// a candidate whose warm-up solve takes longer than this is not timed again, the warm-up
+// counts as its solve time
+static const double TUNE_PROBE_MAX_MS = 1000;
+
+/**
+ * @brief Picks up to count distinct sources with outgoing edges, spread over the ids.
+ */
+static vector<int> sampleSources(const CsrGraph &csr, int count)
+{
+	vector<int> sources;
+	int no_of_nodes = csr.no_of_nodes;
+	for (long long i = 0; i < 64LL * count && (int)sources.size() < count && no_of_nodes > 0; i++)
+	{
+		int v = (int)((i * 2654435761LL) % no_of_nodes);
+		if (csr.offsets[v + 1] > csr.offsets[v] && find(sources.begin(), sources.end(), v) == sources.end())
+			sources.push_back(v);
+	}
+	if (sources.empty())
+		sources.push_back(0);
+	return sources;
+}
+
+static GraphStatistics measureWithCsr(const Graph *graph, const CsrGraph &csr, const vector<int> &sources)
+{
+	GraphStatistics statistics;
+	int no_of_nodes = csr.no_of_nodes;
+	statistics.no_of_nodes = no_of_nodes;
+	statistics.no_of_edges = graph->no_of_edges;
+
+	int max_degree = 0;
+	for (int v = 0; v < no_of_nodes; v++)
+		max_degree = max(max_degree, csr.offsets[v + 1] - csr.offsets[v]);
+	double average_degree = no_of_nodes > 0 ? (double)graph->no_of_edges / no_of_nodes : 0;
+	statistics.degree_skew = average_degree > 0 ? max_degree / average_degree : 0;
+
+	statistics.min_weight = 0;
+	statistics.max_weight = 0;
+	for (int i = 0; i < graph->no_of_edges; i++)
+	{
+		statistics.min_weight = min(statistics.min_weight, graph->edge[i].weight);
+		statistics.max_weight = max(statistics.max_weight, graph->edge[i].weight);
+	}
+
+	statistics.estimated_diameter = 0;
+	vector<int> depth(no_of_nodes), queue(no_of_nodes);
+	for (int source : sources)
+	{
+		fill(depth.begin(), depth.end(), -1);
+		int head = 0, tail = 0;
+		depth[source] = 0;
+		queue[tail++] = source;
+		while (head < tail)
+		{
+			int u = queue[head++];
+			statistics.estimated_diameter = max(statistics.estimated_diameter, depth[u]);
+			for (int j = csr.offsets[u]; j < csr.offsets[u + 1]; j++)
+			{
+				int v = csr.neighbours[j];
+				if (depth[v] < 0)
+				{
+					depth[v] = depth[u] + 1;
+					queue[tail++] = v;
+				}
+			}
+		}
+	}
+
+	return statistics;
+}
+
+static int nodeCountOf(const Graph *graph)
+{
+	int no_of_nodes = graph->no_of_nodes;
+	for (int i = 0; i < graph->no_of_edges; i++)
+		no_of_nodes = max(no_of_nodes, max(graph->edge[i].source, graph->edge[i].destination) + 1);
+	return no_of_nodes;
+}
+
+/**
+ * @brief Measures the statistics the tuner bases its candidates on.
+ *
+ * Degree skew and the weight range take one pass over the edges; the diameter estimate
+ * is the deepest level reached by a BFS from each of no_of_samples sampled sources.
+ */
+GraphStatistics measureGraph(const Graph *graph, int no_of_samples)
+{
+	CsrGraph csr;
+	buildCsr(graph, nodeCountOf(graph), &csr);
+	GraphStatistics statistics = measureWithCsr(graph, csr, sampleSources(csr, no_of_samples));
+	freeCsr(&csr);
+	return statistics;
+}
+
+static Graph *copyGraph(const Graph *graph)
+{
+	Graph *copy = (Graph *)malloc(sizeof(Graph));
+	copy->no_of_nodes = graph->no_of_nodes;
+	copy->no_of_edges = graph->no_of_edges;
+	copy->edge = (Edge *)malloc((size_t)graph->no_of_edges * sizeof(Edge));
+	memcpy(copy->edge, graph->edge, (size_t)graph->no_of_edges * sizeof(Edge));
+	return copy;
+}
+
+/**
+ * @brief Copies the part of a graph a BFS from the sources reaches first, for probing.
+ *
+ * Nodes are taken in BFS order until their out-degrees add up to max_edges. The sample
+ * keeps every out-edge of the taken nodes, and their destinations that were not taken
+ * become sinks, so it has the local structure the solves from the sources run into.
+ * Graphs of at most max_edges edges are copied whole.
+ *
+ * @param sources The sampled sources, renumbered to their ids in the sample.
+ */
+static Graph *sampleGraph(const Graph *graph, const CsrGraph &csr, vector<int> *sources, int max_edges)
+{
+	if (graph->no_of_edges <= max_edges)
+		return copyGraph(graph);
+
+	int no_of_nodes = csr.no_of_nodes;
+	// new id of every queued node, which is its position in order
+	vector<int> new_id(no_of_nodes, -1), order;
+	order.reserve(no_of_nodes);
+	for (int source : *sources)
+	{
+		if (new_id[source] < 0)
+		{
+			new_id[source] = order.size();
+			order.push_back(source);
+		}
+	}
+
+	long long sampled_edges = 0;
+	int taken = 0;
+	// the sources themselves are always taken
+	while (taken < (int)order.size() && (taken < (int)sources->size() || sampled_edges < max_edges))
+	{
+		int u = order[taken++];
+		sampled_edges += csr.offsets[u + 1] - csr.offsets[u];
+		for (int j = csr.offsets[u]; j < csr.offsets[u + 1]; j++)
+		{
+			int v = csr.neighbours[j];
+			if (new_id[v] < 0)
+			{
+				new_id[v] = order.size();
+				order.push_back(v);
+			}
+		}
+	}
+
+	Graph *sample = (Graph *)malloc(sizeof(Graph));
+	sample->no_of_nodes = order.size();
+	sample->no_of_edges = sampled_edges;
+	sample->edge = (Edge *)malloc((size_t)sampled_edges * sizeof(Edge));
+	int e = 0;
+	for (int i = 0; i < taken; i++)
+	{
+		int u = order[i];
+		for (int j = csr.offsets[u]; j < csr.offsets[u + 1]; j++)
+			sample->edge[e++] = {i, new_id[csr.neighbours[j]], csr.weights[j]};
+	}
+
+	for (int &source : *sources)
+		source = new_id[source];
+	return sample;
+}
+
+/**
+ * @brief Finds the fastest engine and thread count for a graph by timing them.
+ *
+ * The statistics rule out candidates that cannot win: dijkstra and async are only tried
+ * without negative weights (async cannot stop early on a negative cycle), the serial
+ * engines (dijkstra, tarjan) only on one thread, spmv only on graphs of small estimated
+ * diameter, and thread counts only while every thread gets TUNE_MIN_EDGES_PER_THREAD
+ * edges of the sample the probes actually run on.
+ *
+ * Probes run on a sample of at most about TUNE_PROBE_MAX_EDGES edges (see sampleGraph),
+ * so tuning a huge graph takes seconds rather than many full solves. Every remaining
+ * candidate gets a solver of its thread count, one warm-up solve that also builds the
+ * layouts the engine needs, and then one timed solve from each sampled source, unless
+ * the warm-up alone took over TUNE_PROBE_MAX_MS. Candidates whose solve fails are
+ * dropped. The layout follows from the engine: edge list (bellman-ford, async), CSR/CSC
+ * (push-pull, dijkstra, tarjan), per-component edge lists (scc) or SELL-C-sigma (spmv).
+ *
+ * @param graph The graph as read from its file, it is sampled once and copied for every
+ * solver.
+ * @param max_threads Largest thread count to try.
+ * @param profile Receives the fastest configuration.
+ * @param probes Receives every timed candidate if not NULL.
+ */
+void tuneSolver(const Graph *graph, int max_threads, TuningProfile *profile, vector<TuningProbe> *probes)
+{
+	CsrGraph csr;
+	buildCsr(graph, nodeCountOf(graph), &csr);
+	vector<int> sources = sampleSources(csr, TUNE_SAMPLED_SOURCES);
+	profile->statistics = measureWithCsr(graph, csr, sources);
+	Graph *sample = sampleGraph(graph, csr, &sources, TUNE_PROBE_MAX_EDGES);
+	freeCsr(&csr);
+
+	const GraphStatistics &statistics = profile->statistics;
+	profile->graph_checksum = graphChecksum(graph);
+	profile->engine = ENGINE_AUTO;
+	profile->num_threads = 1;
+	profile->solve_ms = -1;
+
+	vector<SolverEngine> engines = {ENGINE_BELLMAN_FORD, ENGINE_PUSH_PULL, ENGINE_SCC, ENGINE_TARJAN};
+	if (statistics.estimated_diameter <= TUNE_SPMV_MAX_DIAMETER)
+		engines.push_back(ENGINE_SPMV);
+	if (statistics.min_weight >= 0)
+	{
+		engines.push_back(ENGINE_ASYNC);
+		engines.push_back(ENGINE_DIJKSTRA);
+	}
+
+	vector<int> thread_counts;
+	// counted on the sample, more threads than it can keep busy would only time the overhead
+	int useful_threads = max(1, min(max_threads, sample->no_of_edges / TUNE_MIN_EDGES_PER_THREAD));
+	for (int num_threads = 1; num_threads < useful_threads; num_threads *= 2)
+		thread_counts.push_back(num_threads);
+	thread_counts.push_back(useful_threads);
+
+	for (int num_threads : thread_counts)
+	{
+		Solver solver(num_threads);
+		if (solver.loadGraph(copyGraph(sample)) != SSSP_OK)
+			continue;
+
+		for (SolverEngine engine : engines)
+		{
+			if ((engine == ENGINE_DIJKSTRA || engine == ENGINE_TARJAN) && num_threads != 1)
+				continue;
+
+			solver.setEngine(engine);
+			auto t1 = chrono::steady_clock::now();
+			bool failed = solver.solve(sources[0]) < 0;
+			auto t2 = chrono::steady_clock::now();
+			double solve_ms = chrono::duration<double, milli>(t2 - t1).count();
+
+			if (!failed && solve_ms <= TUNE_PROBE_MAX_MS)
+			{
+				t1 = chrono::steady_clock::now();
+				for (int source : sources)
+					failed = failed || solver.solve(source) < 0;
+				t2 = chrono::steady_clock::now();
+				solve_ms = chrono::duration<double, milli>(t2 - t1).count() / sources.size();
+			}
+			if (failed)
+				continue;
+
+			if (probes != NULL)
+				probes->push_back({engine, num_threads, solve_ms});
+			if (profile->solve_ms < 0 || solve_ms < profile->solve_ms)
+			{
+				profile->engine = engine;
+				profile->num_threads = num_threads;
+				profile->solve_ms = solve_ms;
+			}
+		}
+	}
+	freeGraph(sample);
+}
+
+/**
+ * @brief Reads a profile written by writeTuningProfile.
+ *
+ * @return false if the file is missing, incomplete or holds a value that is not a number.
+ */
+bool readTuningProfile(string path, TuningProfile *profile)
+{
+	ifstream file(path);
+	if (!file.is_open())
+		return false;
+
+	int fields = 0;
+	string line;
+	while (getline(file, line))
+	{
+		if (line.empty() || line[0] == '#')
+			continue;
+
+		istringstream words(line);
+		string key, value;
+		words >> key >> value;
+		GraphStatistics &statistics = profile->statistics;
+		try
+		{
+			if (key == "graph_checksum")
+				profile->graph_checksum = stoull(value);
+			else if (key == "engine" && parseSolverEngine(value, &profile->engine))
+				;
+			else if (key == "threads")
+				profile->num_threads = stoi(value);
+			else if (key == "solve_ms")
+				profile->solve_ms = stod(value);
+			else if (key == "nodes")
+				statistics.no_of_nodes = stoi(value);
+			else if (key == "edges")
+				statistics.no_of_edges = stoi(value);
+			else if (key == "degree_skew")
+				statistics.degree_skew = stod(value);
+			else if (key == "min_weight")
+				statistics.min_weight = stoi(value);
+			else if (key == "max_weight")
+				statistics.max_weight = stoi(value);
+			else if (key == "estimated_diameter")
+				statistics.estimated_diameter = stoi(value);
+			else
+				continue;
+		}
+		// stoi and friends throw on values that are not numbers or do not fit
+		catch (const logic_error &)
+		{
+			return false;
+		}
+		fields++;
+	}
+
+	return fields == 10 && profile->num_threads > 0;
+}
+
+/**
+ * @brief Writes a profile as "key value" lines, so it can be read and edited by hand.
+ */
+bool writeTuningProfile(string path, const TuningProfile &profile)
+{
+	ofstream file(path);
+	if (!file.is_open())
+		return false;
+
+	const GraphStatistics &statistics = profile.statistics;
+	file << "# bellman-ford-sssp tuning profile" << endl
+		 << "graph_checksum " << profile.graph_checksum << endl
+		 << "engine " << solverEngineName(profile.engine) << endl
+		 << "threads " << profile.num_threads << endl
+		 << "solve_ms " << profile.solve_ms << endl
+		 << "nodes " << statistics.no_of_nodes << endl
+		 << "edges " << statistics.no_of_edges << endl
+		 << "degree_skew " << statistics.degree_skew << endl
+		 << "min_weight " << statistics.min_weight << endl
+		 << "max_weight " << statistics.max_weight << endl
+		 << "estimated_diameter " << statistics.estimated_diameter << endl;
+	return (bool)file;
+}
@@ -0,0 +1,47 @@
+#ifndef AUTOTUNE_H
+#define AUTOTUNE_H
+
+#include <string>
+#include <vector>
+#include "graph.h"
+#include "sssp_solver.h"
+
+// cheap statistics the tuner uses to rule out candidates before timing them
+struct GraphStatistics
+{
+	int no_of_nodes;
+	int no_of_edges;
+	// largest out-degree over the average out-degree
+	double degree_skew;
+	int min_weight;
+	int max_weight;
+	// deepest BFS level reached from the sampled sources, a lower bound on the diameter
+	int estimated_diameter;
+};
+
+// one timed candidate configuration
+struct TuningProbe
+{
+	SolverEngine engine;
+	int num_threads;
+	// average time of one solve from the sampled sources
+	double solve_ms;
+};
+
+// best configuration found for one graph, stored in its profile file
+struct TuningProfile
+{
+	// graphChecksum of the graph as read from its file
+	unsigned long long graph_checksum;
+	SolverEngine engine;
+	int num_threads;
+	double solve_ms;
+	GraphStatistics statistics;
+};
+
+GraphStatistics measureGraph(const Graph *graph, int no_of_samples);
+void tuneSolver(const Graph *graph, int max_threads, TuningProfile *profile, std::vector<TuningProbe> *probes = NULL);
+bool readTuningProfile(std::string path, TuningProfile *profile);
+bool writeTuningProfile(std::string path, const TuningProfile &profile);
+
+#endif // AUTOTUNE_H
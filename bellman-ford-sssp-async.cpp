@@ -0,0 +1,97 @@
+#include <iostream>				// For input/output stream
+#include <chrono>				// For high resolution timing
+#include <cstdlib>				// For atoi
+#include <memory>				// For the pending reload
+#include "async_solver.h"		// For the coroutine solver API
+#include "dataset_operations.h" // For dataset operations
+
+using namespace std;
+
+/**
+ * @brief Downloads and extracts the default dataset if needed, then loads the graph.
+ */
+static Task<int> fetchAndLoad(TaskExecutor *executor, AsyncSolver *solver, string input_graph_path, bool download)
+{
+	if (download)
+	{
+		co_await runOnExecutor(executor, []()
+		{
+			download_file("https://suitesparse-collection-website.herokuapp.com/MM/SNAP/higgs-twitter.tar.gz",
+						  "higgs-twitter.tar.gz");
+			extract_tar_file("higgs-twitter.tar.gz");
+			return 0;
+		});
+	}
+	co_return co_await solver->load(input_graph_path);
+}
+
+int main(int argc, char *argv[])
+{
+	// update this variable to provide path to input data file i.e sparse matrix
+	string input_graph_path = argc > 1 ? argv[1] : "higgs-twitter/higgs-twitter.mtx";
+	int num_threads = argc > 2 ? atoi(argv[2]) : 4;
+	int no_of_queries = argc > 3 ? atoi(argv[3]) : 20;
+	SolverEngine engine = ENGINE_AUTO;
+	if (argc > 4 && !parseSolverEngine(argv[4], &engine))
+	{
+		cout << "Unknown engine: " << argv[4] << endl;
+		return 1;
+	}
+	// the graph file is reloaded this many times while the queries run
+	int no_of_reloads = argc > 5 ? atoi(argv[5]) : 1;
+
+	// one executor thread can load the next version while the other answers queries
+	TaskExecutor executor;
+	executor.start(2);
+	AsyncSolver solver(&executor, num_threads, engine);
+
+	auto t1 = chrono::high_resolution_clock::now();
+	if (fetchAndLoad(&executor, &solver, input_graph_path, argc <= 1).get() != SSSP_OK)
+	{
+		cout << "Could not load graph: " << input_graph_path << endl;
+		return 1;
+	}
+	auto t2 = chrono::high_resolution_clock::now();
+	auto duration_1 = chrono::duration_cast<chrono::microseconds>(t2 - t1).count();
+	cout << "Load and preprocessing time (microseconds): " << duration_1 << endl;
+
+	int reload_every = no_of_reloads > 0 ? max(1, no_of_queries / (no_of_reloads + 1)) : no_of_queries + 1;
+	unique_ptr<Task<int>> reload;
+	long long max_latency_us = 0;
+	for (int query = 0; query < no_of_queries; query++)
+	{
+		if (query > 0 && query % reload_every == 0 && no_of_reloads > 0)
+		{
+			// the previous reload has to finish before the next one starts
+			if (reload != NULL && reload->get() != SSSP_OK)
+				cout << "Reload failed" << endl;
+			reload = make_unique<Task<int>>(solver.load(input_graph_path));
+			reload->start();
+			no_of_reloads--;
+			cout << "Reloading " << input_graph_path << " in the background" << endl;
+		}
+
+		int source_node_id = query % solver.current()->solver.nodeCount();
+		t1 = chrono::high_resolution_clock::now();
+		AsyncSolveResult result = solver.solve(source_node_id).get();
+		t2 = chrono::high_resolution_clock::now();
+		duration_1 = chrono::duration_cast<chrono::microseconds>(t2 - t1).count();
+		max_latency_us = max(max_latency_us, (long long)duration_1);
+
+		if (result.status == SSSP_NEGATIVE_CYCLE)
+			cout << "Negative weight edge cycle is present in the graph\n";
+		cout << "Source " << source_node_id << " on graph version " << result.graph_version << ": "
+			 << result.rounds << " rounds, ";
+		if (result.distances.size() > 100)
+			cout << "distance to node 100 is " << result.distances[100] << ", ";
+		cout << "latency (microseconds): " << duration_1 << endl;
+	}
+
+	if (reload != NULL && reload->get() != SSSP_OK)
+		cout << "Reload failed" << endl;
+	cout << "Largest query latency (microseconds): " << max_latency_us << ", current graph version "
+		 << solver.current()->version << endl;
+
+	executor.stop();
+	return 0;
+}
@@ -0,0 +1,64 @@
+#include <iostream>				// For input/output stream
+#include <chrono>				// For high resolution timing
+#include <cstdlib>				// For atoi
+#include "graph.h"				// For graph data structure
+#include "partitioned_sssp.h"	// For the partitioned solve
+#include "sssp_c_api.h"			// For status codes
+#include "dataset_operations.h" // For dataset operations
+
+using namespace std;
+
+int main(int argc, char *argv[])
+{
+	// update this variable to provide path to input data file i.e sparse matrix
+	string input_graph_path = "higgs-twitter/higgs-twitter.mtx";
+	int no_of_partitions = argc > 2 ? atoi(argv[2]) : 4;
+	int source_node_id = argc > 3 ? atoi(argv[3]) : 0;
+
+	// a graph file given on the command line (e.g. from graph-generator) skips the download
+	if (argc > 1)
+	{
+		input_graph_path = argv[1];
+	}
+	else
+	{
+		download_file("https://suitesparse-collection-website.herokuapp.com/MM/SNAP/higgs-twitter.tar.gz",
+					  "higgs-twitter.tar.gz");
+		extract_tar_file("higgs-twitter.tar.gz");
+	}
+
+	struct Graph *graph = loadGraph(input_graph_path);
+	if (graph == NULL || graph->edge == NULL)
+	{
+		cout << "Could not load graph: " << input_graph_path << endl;
+		return 1;
+	}
+
+	vector<long> distances;
+	vector<PartitionStats> stats;
+
+	auto t1 = chrono::high_resolution_clock::now();
+	int status = solvePartitioned(graph, source_node_id, no_of_partitions, &distances, &stats);
+	auto t2 = chrono::high_resolution_clock::now();
+	auto duration_1 = chrono::duration_cast<chrono::microseconds>(t2 - t1).count();
+
+	if (status < 0)
+	{
+		cout << "Partitioned solve failed with status " << status << endl;
+		return 1;
+	}
+	if (status == SSSP_NEGATIVE_CYCLE)
+		cout << "Negative weight edge cycle is present in the graph\n";
+
+	cout << "No. of processes = " << no_of_partitions << ", rounds = " << stats[0].rounds << endl;
+	for (int p = 0; p < no_of_partitions; p++)
+		cout << "  partition " << p << ": " << stats[p].local_edges << " local edges, " << stats[p].boundary_edges
+			 << " boundary edges, " << stats[p].boundary_updates_sent << " boundary updates sent" << endl;
+
+	if ((int)distances.size() > 100)
+		cout << "Shortest Distance from node " << source_node_id << " to 100 is: " << distances[100] << endl;
+	cout << "Execution time (microseconds): " << duration_1 << endl;
+
+	freeGraph(graph);
+	return 0;
+}
@@ -1,5 +1,8 @@
 #include <sstream>				// For string stream operations
 #include <pthread.h>			// For multithreading operations
+#include <chrono>				// For high resolution timing
+#include <limits>				// For limits of data types
+#include <vector>				// For vector data structure
 #include "graph.h"				// For graph data structure
 #include "dataset_operations.h" // For dataset operations
 
@@ -104,23 +107,42 @@ void runBellmanFordSSSP(int source_node_id)
 			cout << "Negative weight edge cycle is present in the graph\n";
 	}
 
-	cout << "Shortest Distance from node 0 to 100 is: ";
-	cout << node_distances[100] << endl;
+	// graphs with fewer nodes have no node 100
+	if (node_distances.size() > 100)
+	{
+		cout << "Shortest Distance from node 0 to 100 is: ";
+		cout << node_distances[100] << endl;
+	}
 
 	return;
 }
 
-int main()
+int main(int argc, char *argv[])
 {
 	int source_node_id = 0;
 
-	download_file("https://suitesparse-collection-website.herokuapp.com/MM/SNAP/higgs-twitter.tar.gz",
-				  "higgs-twitter.tar.gz");
-	extract_tar_file("higgs-twitter.tar.gz");
 	// update this variable to provide path to input data file i.e sparse matrix
 	string input_graph_path = "higgs-twitter/higgs-twitter.mtx";
 
-	graph = readGraph(input_graph_path);
+	// a graph file given on the command line (e.g. from graph-generator) skips the download
+	if (argc > 1)
+	{
+		input_graph_path = argv[1];
+	}
+	else
+	{
+		download_file("https://suitesparse-collection-website.herokuapp.com/MM/SNAP/higgs-twitter.tar.gz",
+					  "higgs-twitter.tar.gz");
+		extract_tar_file("higgs-twitter.tar.gz");
+	}
+
+	graph = loadGraph(input_graph_path);
+	if (graph == NULL || graph->edge == NULL)
+	{
+		cout << "Could not load graph: " << input_graph_path << endl;
+		freeGraph(graph);
+		return 1;
+	}
 
 	cout << endl
 		 << "No. of threads = 2" << endl;
@@ -1,5 +1,10 @@
+#include <chrono>				// For high resolution timing
+#include <limits>				// For limits of data types
+#include <vector>				// For vector data structure
 #include "graph.h"				// For graph data structure
 #include "dataset_operations.h" // For dataset operations
+#include "perf_counters.h"		// For per-round hardware counter traces
+#include "distance_store.h"		// For reusable distance storage
 
 using namespace std;
 
@@ -17,25 +22,28 @@ using namespace std;
  *
  * @param graph A pointer to the graph on which the algorithm should be run.
  * @param source_node_id The ID of the source node from which the shortest paths should be found.
+ * @param distance_store Distance storage reused across solves, sized for every node id.
  */
-void runBellmanFordSSSP(struct Graph *graph, int source_node_id)
+void runBellmanFordSSSP(struct Graph *graph, int source_node_id, DistanceStore64 &distance_store)
 {
 	int no_of_nodes = graph->no_of_nodes;
 	int no_of_edges = graph->no_of_edges;
 
-	// distance of node 10 will be at index 10.
-	long node_distances[no_of_nodes];
+	// setting every distance to infinity and the source node to zero
+	long *node_distances = distance_store.fill(source_node_id);
 
-	// setting initial distances to infinity
-	for (int i = 0; i < no_of_nodes; i++)
-		node_distances[i] = numeric_limits<int>::max() - 100;
-
-	// setting the distance of the source node to zero
-	node_distances[source_node_id] = 0;
+	// per-round trace, only collected when BF_ROUND_TRACE is set
+	RoundTrace trace;
+	roundTraceInit(&trace, "serial");
+	// round in which each node was last improved, used to count active vertices
+	vector<int> improved_in_round(trace.enabled ? no_of_nodes : 0, -1);
 
 	for (int i = 0; i < no_of_nodes - 1; i++)
 	{
 		bool relaxed = false;
+		long long relaxations = 0, active_vertices = 0;
+
+		roundTraceBegin(&trace, i);
 
 		for (int j = 0; j < no_of_edges; j++)
 		{
@@ -48,9 +56,21 @@ void runBellmanFordSSSP(struct Graph *graph, int source_node_id)
 			{
 				node_distances[node_2] = node_distances[node_1] + weight;
 				relaxed = true;
+
+				if (trace.enabled)
+				{
+					relaxations++;
+					if (improved_in_round[node_2] != i)
+					{
+						improved_in_round[node_2] = i;
+						active_vertices++;
+					}
+				}
 			}
 		}
 
+		roundTraceEnd(&trace, no_of_edges, relaxations, active_vertices);
+
 		// if no edge was relaxed in this iteration
 		// then stop iterating
 		if (!relaxed)
@@ -59,6 +79,8 @@ void runBellmanFordSSSP(struct Graph *graph, int source_node_id)
 		}
 	}
 
+	roundTraceFinish(&trace);
+
 	// checking for negative weight cycle
 	for (int i = 0; i < no_of_edges; i++)
 	{
@@ -71,28 +93,49 @@ void runBellmanFordSSSP(struct Graph *graph, int source_node_id)
 			cout << "Negative weight edge cycle is present in the graph\n";
 	}
 
-	cout << "Shortest Distance from node 0 to 100 is: ";
-	cout << node_distances[100] << endl;
+	// graphs with fewer nodes have no node 100
+	if (distance_store.size() > 100)
+	{
+		cout << "Shortest Distance from node 0 to 100 is: ";
+		cout << node_distances[100] << endl;
+	}
 
 	return;
 }
 
-int main()
+int main(int argc, char *argv[])
 {
 
-	download_file("https://suitesparse-collection-website.herokuapp.com/MM/SNAP/higgs-twitter.tar.gz",
-				  "higgs-twitter.tar.gz");
-	extract_tar_file("higgs-twitter.tar.gz");
 	// update this variable to provide path to input data file i.e sparse matrix
 	string input_graph_path = "higgs-twitter/higgs-twitter.mtx";
 
+	// a graph file given on the command line (e.g. from graph-generator) skips the download
+	if (argc > 1)
+	{
+		input_graph_path = argv[1];
+	}
+	else
+	{
+		download_file("https://suitesparse-collection-website.herokuapp.com/MM/SNAP/higgs-twitter.tar.gz",
+					  "higgs-twitter.tar.gz");
+		extract_tar_file("higgs-twitter.tar.gz");
+	}
+
 	int source_node_id = 0;
 
-	struct Graph *graph = readGraph(input_graph_path);
+	struct Graph *graph = loadGraph(input_graph_path);
+	if (graph == NULL || graph->edge == NULL)
+	{
+		cout << "Could not load graph: " << input_graph_path << endl;
+		freeGraph(graph);
+		return 1;
+	}
+	// the extra slot covers the 1-based ids of .mtx files
+	DistanceStore64 distance_store(graph->no_of_nodes + 1);
 
 	auto t1 = chrono::high_resolution_clock::now();
 
-	runBellmanFordSSSP(graph, source_node_id);
+	runBellmanFordSSSP(graph, source_node_id, distance_store);
 
 	auto t2 = chrono::high_resolution_clock::now();
 
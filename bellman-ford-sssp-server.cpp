@@ -0,0 +1,77 @@
+#include <iostream>				// For input/output stream
+#include <chrono>				// For high resolution timing
+#include <csignal>				// For shutdown signals
+#include <cstdlib>				// For atoi
+#include <pthread.h>			// For the signal thread
+#include "sssp_server.h"		// For the query server
+#include "dataset_operations.h" // For dataset operations
+
+using namespace std;
+
+static sigset_t shutdown_signals;
+
+/**
+ * @brief Waits for SIGINT or SIGTERM and stops the server.
+ */
+void *waitForShutdown(void *arg)
+{
+	int signal_number;
+	sigwait(&shutdown_signals, &signal_number);
+	cout << "Shutting down" << endl;
+	((SsspServer *)arg)->stop();
+	return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+	// update this variable to provide path to input data file i.e sparse matrix
+	string input_graph_path = "higgs-twitter/higgs-twitter.mtx";
+
+	// a graph file given on the command line (e.g. from graph-generator) skips the download
+	if (argc > 1)
+	{
+		input_graph_path = argv[1];
+	}
+	else
+	{
+		download_file("https://suitesparse-collection-website.herokuapp.com/MM/SNAP/higgs-twitter.tar.gz",
+					  "higgs-twitter.tar.gz");
+		extract_tar_file("higgs-twitter.tar.gz");
+	}
+
+	ServerOptions options;
+	options.socket_path = argc > 2 ? argv[2] : "/tmp/bellman-ford-sssp.sock";
+	int num_threads = argc > 3 ? atoi(argv[3]) : 4;
+	options.batch_window_us = argc > 4 ? atoi(argv[4]) : 2000;
+	options.max_batch = argc > 5 ? atoi(argv[5]) : SOLVER_MAX_BATCH;
+	options.cache_budget_bytes = (size_t)(argc > 6 ? atoi(argv[6]) : 256) << 20;
+
+	// the signal thread is the only one that receives shutdown signals
+	sigemptyset(&shutdown_signals);
+	sigaddset(&shutdown_signals, SIGINT);
+	sigaddset(&shutdown_signals, SIGTERM);
+	pthread_sigmask(SIG_BLOCK, &shutdown_signals, NULL);
+
+	Solver solver(num_threads);
+
+	auto t1 = chrono::high_resolution_clock::now();
+	if (solver.load(input_graph_path) != SSSP_OK)
+	{
+		cout << "Could not load graph: " << input_graph_path << endl;
+		return 1;
+	}
+	auto t2 = chrono::high_resolution_clock::now();
+	auto duration_1 = chrono::duration_cast<chrono::microseconds>(t2 - t1).count();
+	cout << "Graph loaded once in (microseconds): " << duration_1 << endl;
+
+	SsspServer server(&solver, options);
+	pthread_t signal_thread;
+	pthread_create(&signal_thread, NULL, waitForShutdown, &server);
+	pthread_detach(signal_thread);
+
+	cout << "Serving queries on " << options.socket_path << " (batch window " << options.batch_window_us
+		 << " us, up to " << options.max_batch << " sources per sweep, "
+		 << (options.cache_budget_bytes >> 20) << " MB result cache)" << endl;
+
+	return server.run() == 0 ? 0 : 1;
+}
@@ -14,8 +14,11 @@
 // SIMD Intrinsics header
 #include <arm_neon.h> // For ARM-specific SIMD intrinsics
 
-// Custom header
+// Custom headers
 #include "dataset_operations.h" // For dataset operations
+#include "perf_counters.h"		// For per-round hardware counter traces
+#include "arena.h"				// For huge-page backed edge arrays
+#include "distance_store.h"		// For reusable distance storage
 
 using namespace std;
 
@@ -46,9 +49,11 @@ struct Graph
  * The function creates a new Graph structure, populates it with the data from the file, and returns a pointer to it.
  *
  * @param input_graph_path The path to the file containing the graph data.
- * @return A pointer to the newly created Graph structure.
+ * @param arena The arena the edge arrays are allocated from, so the kernels read them from huge pages.
+ * @return A pointer to the newly created Graph structure, or NULL if the edge arrays
+ * could not be allocated.
  */
-struct Graph *readGraph(string input_graph_path)
+struct Graph *readGraph(string input_graph_path, Arena *arena)
 {
 	struct Graph *graph = (struct Graph *)malloc(sizeof(struct Graph));
 
@@ -70,9 +75,14 @@ struct Graph *readGraph(string input_graph_path)
 				graph->no_of_nodes = no_of_nodes;
 				graph->no_of_edges = no_of_edges;
 
-				graph->sourceIds = new int[no_of_edges];
-				graph->destIds = new int[no_of_edges];
-				graph->weights = new int[no_of_edges];
+				graph->sourceIds = arena->allocateArray<int>(no_of_edges);
+				graph->destIds = arena->allocateArray<int>(no_of_edges);
+				graph->weights = arena->allocateArray<int>(no_of_edges);
+				if (graph->sourceIds == NULL || graph->destIds == NULL || graph->weights == NULL)
+				{
+					free(graph);
+					return NULL;
+				}
 			}
 			else
 			{
@@ -94,6 +104,40 @@ struct Graph *readGraph(string input_graph_path)
 	return graph;
 }
 
+/**
+ * @brief Counts the relaxations of one vector of edges for the round trace.
+ *
+ * Only called when tracing is enabled. A destination counts as an active vertex the
+ * first time it is improved in a round.
+ *
+ * @param mask Lanes whose new distance was smaller than the old one.
+ * @param vd Destination node ids of the four edges.
+ * @param round The current round.
+ * @param improved_in_round Round in which each node was last improved.
+ * @param relaxations Incremented by the number of set lanes.
+ * @param active_vertices Incremented by the number of newly improved nodes.
+ */
+static void countRelaxations(uint32x4_t mask, int32x4_t vd, int round, vector<int> &improved_in_round,
+							 long long &relaxations, long long &active_vertices)
+{
+	uint32_t lanes[4];
+	int32_t destinations[4];
+	vst1q_u32(lanes, mask);
+	vst1q_s32(destinations, vd);
+
+	for (int lane = 0; lane < 4; lane++)
+	{
+		if (!lanes[lane])
+			continue;
+		relaxations++;
+		if (improved_in_round[destinations[lane]] != round)
+		{
+			improved_in_round[destinations[lane]] = round;
+			active_vertices++;
+		}
+	}
+}
+
 /**
  * @brief Runs the Bellman-Ford algorithm for Single-Source Shortest Paths (SSSP) using SIMD instructions.
  *
@@ -107,26 +151,32 @@ struct Graph *readGraph(string input_graph_path)
  *              - destIds: An array of integers that represent the destination nodes of the edges.
  *              - weights: An array of integers that represent the weights of the edges.
  * @param source_node_id The id of the source node for the SSSP problem.
+ * @param distance_store Distance storage reused across solves, sized for every node id.
  *
  * @return void
  */
-void runBellmanFordSsspSIMD(struct Graph *graph, int source_node_id)
+void runBellmanFordSsspSIMD(struct Graph *graph, int source_node_id, DistanceStore32 &distance_store)
 {
 	int no_of_nodes = graph->no_of_nodes;
 	int no_of_edges = graph->no_of_edges;
 
-	// distance of node 10 will be at index 10.
-	int node_distances[no_of_nodes];
-
-	// setting initial distances
-	for (int i = 0; i < no_of_nodes; i++)
-		node_distances[i] = numeric_limits<int>::max() - 100;
+	// setting every distance to infinity and the source node to zero
+	int32_t *node_distances = distance_store.fill(source_node_id);
 
-	node_distances[source_node_id] = 0;
+	// per-round trace, only collected when BF_ROUND_TRACE is set
+	RoundTrace trace;
+	roundTraceInit(&trace, "simd");
+	// round in which each node was last improved, used to count active vertices
+	vector<int> improved_in_round(trace.enabled ? no_of_nodes : 0, -1);
+	// the kernel handles four edges per step of sixteen
+	long long edges_scanned = (no_of_edges + 15) / 16 * 4LL;
 
 	for (int i = 0; i < no_of_nodes - 1; i++)
 	{
 		bool relaxed = false;
+		long long relaxations = 0, active_vertices = 0;
+
+		roundTraceBegin(&trace, i);
 
 		for (int j = 0; j < no_of_edges; j += 16)
 		{
@@ -172,8 +222,15 @@ void runBellmanFordSsspSIMD(struct Graph *graph, int source_node_id)
 			if (mask[3]) {
 				node_distances[vgetq_lane_s32(vd, 3)] = temp[3];
 			}
+
+			if (trace.enabled)
+			{
+				countRelaxations(mask, vd, i, improved_in_round, relaxations, active_vertices);
+			}
 		}
 
+		roundTraceEnd(&trace, edges_scanned, relaxations, active_vertices);
+
 		// if no edge was relaxed in this iteration
 		// then stop iterating
 		if (!relaxed)
@@ -182,6 +239,8 @@ void runBellmanFordSsspSIMD(struct Graph *graph, int source_node_id)
 		}
 	}
 
+	roundTraceFinish(&trace);
+
 	// checking for negative weight cycle
 	for (int i = 0; i < no_of_edges; i++)
 	{
@@ -214,13 +273,16 @@ void runBellmanFordSsspSIMD(struct Graph *graph, int source_node_id)
  *              - destIds: An array of integers that represent the destination nodes of the edges.
  *              - weights: An array of integers that represent the weights of the edges.
  * @param source_node_id The id of the source node for the SSSP problem.
+ * @param distance_store Distance storage reused across solves, sized for every node id.
+ * @param arena The arena used for the scratch arrays of the tiling pass.
  *
  * @return void
  *
  * @note This function prints the presence of a negative weight edge cycle in the graph if it exists.
  * It also prints the shortest distance from the source node to node 100.
  */
-void runBellmanFordSsspSIMDTilling(struct Graph *graph, int source_node_id)
+void runBellmanFordSsspSIMDTilling(struct Graph *graph, int source_node_id, DistanceStore32 &distance_store,
+								   Arena *arena)
 {
 	int no_of_nodes = graph->no_of_nodes;
 	int no_of_edges = graph->no_of_edges;
@@ -228,45 +290,56 @@ void runBellmanFordSsspSIMDTilling(struct Graph *graph, int source_node_id)
 	cout << "Tilling process is started. " << endl;
 
 	int tile_size = 1024;
-	int no_of_tiles = ceil(no_of_nodes / tile_size);
+	// one extra tile covers the ids of 1-based .mtx files
+	int no_of_tiles = no_of_nodes / tile_size + 1;
 
-	vector<tuple<int, int, float>> coo_tiles[no_of_tiles];
-	for (int i = 0; i < no_of_edges; i++)
-	{
-		int tile_id = graph->destIds[i] / tile_size;
-		// Add the source node, destination node, and weight of the current edge
-		// to the corresponding tile in the coo_tiles vector
-		coo_tiles[tile_id].push_back(make_tuple(graph->sourceIds[i], graph->destIds[i], graph->weights[i]));
-	}
-	// Initialize a counter to keep track of the current edge index
-	int count = 0;
-	// Reorganizing the edges in the graph based on the tiles
+	// Reorganizing the edges in the graph based on the tiles with a counting sort
+	// into preallocated arrays, instead of growing one vector per tile edge by edge.
 	// This is done to optimize memory access patterns and improve cache efficiency during
 	// the execution of the Bellman-Ford algorithm.
+	int *tile_offsets = arena->allocateArray<int>(no_of_tiles + 1);
+	int *tiled_sources = arena->allocateArray<int>(no_of_edges);
+	int *tiled_destinations = arena->allocateArray<int>(no_of_edges);
+	int *tiled_weights = arena->allocateArray<int>(no_of_edges);
+	if (tile_offsets == NULL || tiled_sources == NULL || tiled_destinations == NULL || tiled_weights == NULL)
+	{
+		cout << "Could not allocate the tiled edge arrays" << endl;
+		return;
+	}
+	for (int i = 0; i < no_of_edges; i++)
+		tile_offsets[graph->destIds[i] / tile_size + 1]++;
 	for (int i = 0; i < no_of_tiles; i++)
+		tile_offsets[i + 1] += tile_offsets[i];
+
+	for (int i = 0; i < no_of_edges; i++)
 	{
-		for (auto &t : coo_tiles[i])
-		{
-			graph->sourceIds[count] = get<0>(t);
-			graph->destIds[count] = get<1>(t);
-			graph->weights[count] = get<2>(t);
-			count++;
-		}
+		int position = tile_offsets[graph->destIds[i] / tile_size]++;
+		tiled_sources[position] = graph->sourceIds[i];
+		tiled_destinations[position] = graph->destIds[i];
+		tiled_weights[position] = graph->weights[i];
 	}
+	graph->sourceIds = tiled_sources;
+	graph->destIds = tiled_destinations;
+	graph->weights = tiled_weights;
 	cout << "Tilling process is completed. " << endl;
 
-	// distance of node 10 will be at index 10.
-	int node_distances[no_of_nodes];
+	// setting every distance to infinity and the source node to zero
+	int32_t *node_distances = distance_store.fill(source_node_id);
 
-	// setting initial distances
-	for (int i = 0; i < no_of_nodes; i++)
-		node_distances[i] = numeric_limits<int>::max() - 100;
-
-	node_distances[source_node_id] = 0;
+	// per-round trace, only collected when BF_ROUND_TRACE is set
+	RoundTrace trace;
+	roundTraceInit(&trace, "simd-tiling");
+	// round in which each node was last improved, used to count active vertices
+	vector<int> improved_in_round(trace.enabled ? no_of_nodes : 0, -1);
+	// the kernel handles four edges per step of sixteen
+	long long edges_scanned = (no_of_edges + 15) / 16 * 4LL;
 
 	for (int i = 0; i < no_of_nodes - 1; i++)
 	{
 		bool relaxed = false;
+		long long relaxations = 0, active_vertices = 0;
+
+		roundTraceBegin(&trace, i);
 
 		for (int j = 0; j < no_of_edges; j += 16)
 		{
@@ -307,8 +380,15 @@ void runBellmanFordSsspSIMDTilling(struct Graph *graph, int source_node_id)
 			if (mask[3]) {
 				node_distances[vgetq_lane_s32(vd, 3)] = temp[3];
 			}
+
+			if (trace.enabled)
+			{
+				countRelaxations(mask, vd, i, improved_in_round, relaxations, active_vertices);
+			}
 		}
 
+		roundTraceEnd(&trace, edges_scanned, relaxations, active_vertices);
+
 		// if no edge was relaxed in this iteration
 		// then stop iterating
 		if (!relaxed)
@@ -317,6 +397,8 @@ void runBellmanFordSsspSIMDTilling(struct Graph *graph, int source_node_id)
 		}
 	}
 
+	roundTraceFinish(&trace);
+
 	// checking for negative weight cycle
 	for (int i = 0; i < no_of_edges; i++)
 	{
@@ -345,16 +427,25 @@ int main()
 	// update this variable to provide path to input data file i.e sparse matrix
 	string input_graph_path = "higgs-twitter/higgs-twitter.mtx";
 
-	struct Graph *graph = readGraph(input_graph_path);
+	// edge arrays live in huge pages, BF_ARENA_PAGES=4k runs the same code on regular pages
+	Arena arena(arenaPageSizeFromEnvironment());
+	struct Graph *graph = readGraph(input_graph_path, &arena);
+	if (graph == NULL)
+	{
+		cout << "Could not allocate the edge arrays of " << input_graph_path << endl;
+		return 1;
+	}
+	// one store serves both kernels, the extra slot covers the 1-based ids of .mtx files
+	DistanceStore32 distance_store(graph->no_of_nodes + 1, &arena);
 
 	auto t1 = chrono::high_resolution_clock::now();
-	runBellmanFordSsspSIMD(graph, source_node_id);
+	runBellmanFordSsspSIMD(graph, source_node_id, distance_store);
 	auto t2 = chrono::high_resolution_clock::now();
 	auto duration_1 = chrono::duration_cast<chrono::microseconds>(t2 - t1).count();
 	cout << "Execution time (microseconds): " << duration_1 << endl;
 
 	t1 = chrono::high_resolution_clock::now();
-	runBellmanFordSsspSIMDTilling(graph, source_node_id);
+	runBellmanFordSsspSIMDTilling(graph, source_node_id, distance_store, &arena);
 	t2 = chrono::high_resolution_clock::now();
 	duration_1 = chrono::duration_cast<chrono::microseconds>(t2 - t1).count();
 	cout << "Execution time (microseconds): " << duration_1 << endl;
@@ -0,0 +1,207 @@
+#include <iostream>				// For input/output stream
+#include <chrono>				// For high resolution timing
+#include <cstdlib>				// For atoi
+#include <cstring>				// For strcmp
+#include <vector>				// For vector data structure
+#include "sssp_solver.h"		// For the reusable solver
+#include "autotune.h"			// For the tuning profiles
+#include "dataset_operations.h" // For dataset operations
+
+using namespace std;
+
+int main(int argc, char *argv[])
+{
+	// checkpoint flags may appear anywhere, everything else is positional
+	string checkpoint_path = "bellman-ford-sssp.checkpoint";
+	int checkpoint_interval = 0;
+	bool resume = false;
+	bool pruning = true;
+	bool tune = false;
+	int max_hops = -1;
+	vector<char *> positional = {argv[0]};
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc)
+			checkpoint_path = argv[++i];
+		else if (strcmp(argv[i], "--checkpoint-every") == 0 && i + 1 < argc)
+			checkpoint_interval = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--resume") == 0)
+			resume = true;
+		else if (strcmp(argv[i], "--no-prune") == 0)
+			pruning = false;
+		else if (strcmp(argv[i], "--tune") == 0)
+			tune = true;
+		else if (strcmp(argv[i], "--hops") == 0 && i + 1 < argc)
+			max_hops = atoi(argv[++i]);
+		else
+			positional.push_back(argv[i]);
+	}
+	argc = positional.size();
+	argv = positional.data();
+
+	// update this variable to provide path to input data file i.e sparse matrix
+	string input_graph_path = "higgs-twitter/higgs-twitter.mtx";
+	int num_threads = argc > 2 ? atoi(argv[2]) : 4;
+	int no_of_queries = argc > 3 ? atoi(argv[3]) : 5;
+	SolverEngine engine = ENGINE_AUTO;
+	if (argc > 4 && !parseSolverEngine(argv[4], &engine))
+	{
+		cout << "Unknown engine: " << argv[4] << endl;
+		return 1;
+	}
+
+	// a graph file given on the command line (e.g. from graph-generator) skips the download
+	if (argc > 1)
+	{
+		input_graph_path = argv[1];
+	}
+	else
+	{
+		download_file("https://suitesparse-collection-website.herokuapp.com/MM/SNAP/higgs-twitter.tar.gz",
+					  "higgs-twitter.tar.gz");
+		extract_tar_file("higgs-twitter.tar.gz");
+	}
+
+	// "numa" as fifth argument pins the workers and places memory per NUMA node
+	bool numa_aware = argc > 5 && string(argv[5]) == "numa";
+
+	// --tune replaces the engine and thread count with the best ones measured for this graph,
+	// stored next to it so later runs skip the measurements
+	Graph *tuned_graph = NULL;
+	if (tune)
+	{
+		tuned_graph = ::loadGraph(input_graph_path);
+		if (tuned_graph == NULL || tuned_graph->edge == NULL)
+		{
+			cout << "Could not load graph: " << input_graph_path << endl;
+			return 1;
+		}
+
+		string profile_path = input_graph_path + ".tune";
+		TuningProfile profile;
+		if (readTuningProfile(profile_path, &profile) && profile.graph_checksum == graphChecksum(tuned_graph))
+			cout << "Tuning profile: " << profile_path << endl;
+		else
+		{
+			vector<TuningProbe> probes;
+			tuneSolver(tuned_graph, num_threads, &profile, &probes);
+			for (const TuningProbe &probe : probes)
+				cout << "  " << solverEngineName(probe.engine) << " on " << probe.num_threads
+					 << " threads: " << probe.solve_ms << " ms per solve" << endl;
+			if (!writeTuningProfile(profile_path, profile))
+				cout << "Could not write tuning profile: " << profile_path << endl;
+		}
+		cout << "Tuned: " << solverEngineName(profile.engine) << " on " << profile.num_threads
+			 << " threads (diameter estimate " << profile.statistics.estimated_diameter << ", degree skew "
+			 << profile.statistics.degree_skew << ")" << endl;
+		engine = profile.engine;
+		num_threads = profile.num_threads;
+	}
+
+	Solver solver(num_threads);
+	solver.setEngine(engine);
+	solver.setNumaAware(numa_aware);
+	solver.setPruning(pruning);
+	if (solver.setCheckpoint(checkpoint_path, checkpoint_interval) != SSSP_OK)
+	{
+		cout << "Invalid checkpoint interval: " << checkpoint_interval << endl;
+		return 1;
+	}
+
+	auto t1 = chrono::high_resolution_clock::now();
+	int load_status = tuned_graph != NULL ? solver.loadGraph(tuned_graph) : solver.load(input_graph_path);
+	if (load_status != SSSP_OK)
+	{
+		cout << "Could not load graph: " << input_graph_path << endl;
+		return 1;
+	}
+	auto t2 = chrono::high_resolution_clock::now();
+	auto duration_1 = chrono::duration_cast<chrono::microseconds>(t2 - t1).count();
+	cout << "Load and preprocessing time (microseconds): " << duration_1 << endl;
+	const EdgeReduction &reduction = solver.edgeReduction();
+	cout << "Edges: " << reduction.input_edges << " read, " << reduction.self_loops << " self-loops and "
+		 << reduction.parallel_edges << " parallel edges removed, " << reduction.output_edges << " relaxed per round"
+		 << endl;
+
+	cout << endl
+		 << "No. of threads = " << solver.numThreads() << (numa_aware ? " (NUMA-aware)" : "") << endl;
+	if (numa_aware && !solver.distancesInterleaved())
+		cout << "Could not interleave the distance array over the NUMA nodes" << endl;
+	if (engine == ENGINE_AUTO)
+		cout << "Engine: " << (solver.activeEngine() == ENGINE_DIJKSTRA ? "dijkstra" : "bellman-ford")
+			 << " (selected from the edge weights)" << endl;
+
+	// --hops answers the queries in batches of hop-bounded solves instead
+	for (int first = 0; max_hops >= 0 && first < no_of_queries; first += SOLVER_MAX_BATCH)
+	{
+		vector<int> sources;
+		for (int query = first; query < min(no_of_queries, first + SOLVER_MAX_BATCH); query++)
+			sources.push_back(query % solver.nodeCount());
+
+		t1 = chrono::high_resolution_clock::now();
+		int status = solver.solveHops(sources.data(), sources.size(), max_hops);
+		t2 = chrono::high_resolution_clock::now();
+		duration_1 = chrono::duration_cast<chrono::microseconds>(t2 - t1).count();
+		if (status != SSSP_OK)
+		{
+			cout << "Invalid hop-bounded query" << endl;
+			return 1;
+		}
+
+		cout << sources.size() << " sources within " << max_hops << " hops: " << solver.rounds()
+			 << " hops, execution time (microseconds): " << duration_1 << endl;
+		for (int lane = 0; lane < (int)sources.size() && solver.nodeCount() > 100; lane++)
+			cout << "  Source " << sources[lane] << ": distance to node 100 is " << solver.hopDistance(lane, 100)
+				 << endl;
+	}
+
+	// the same solver answers every query, reusing threads and buffers
+	for (int query = 0; max_hops < 0 && query < no_of_queries; query++)
+	{
+		int source_node_id = query % solver.nodeCount();
+
+		t1 = chrono::high_resolution_clock::now();
+		int status;
+		// --resume continues the first query from the last checkpoint instead of round zero
+		if (resume && query == 0)
+		{
+			status = solver.resume(checkpoint_path);
+			if (status < 0)
+			{
+				cout << "Could not resume from checkpoint: " << checkpoint_path << endl;
+				return 1;
+			}
+		}
+		else
+			status = solver.solve(source_node_id);
+		t2 = chrono::high_resolution_clock::now();
+		duration_1 = chrono::duration_cast<chrono::microseconds>(t2 - t1).count();
+
+		if (status == SSSP_NEGATIVE_CYCLE)
+			cout << "Negative weight edge cycle is present in the graph\n";
+		cout << "Source " << source_node_id << ": " << solver.rounds() << " rounds, ";
+		if (engine == ENGINE_PUSH_PULL)
+			cout << solver.pullRounds() << " of them pull, ";
+		if (solver.nodeCount() > 100)
+			cout << "distance to node 100 is " << solver.distances()[100] << ", ";
+		cout << "execution time (microseconds): " << duration_1 << endl;
+
+		if (engine == ENGINE_SPMV && query == 0)
+			cout << "  SpMV kernel: " << sellKernelBackend() << endl;
+		if (engine == ENGINE_SCC && query == 0)
+			cout << "  " << solver.sccDecomposition().no_of_components << " strongly connected components in "
+				 << solver.sccDecomposition().no_of_levels << " levels, the largest has "
+				 << solver.sccDecomposition().largest_component << " nodes" << endl;
+
+		const PruningStats &pruning_stats = solver.pruningStats();
+		if (pruning_stats.compacted)
+			cout << "  pruned to " << pruning_stats.reachable_nodes << " reachable nodes and "
+				 << pruning_stats.reachable_edges << " edges in " << pruning_stats.prepass_ns / 1000
+				 << " microseconds, saving " << pruning_stats.skipped_edge_scans << " edge scans" << endl;
+		else if (pruning_stats.reachable_nodes > 0)
+			cout << "  not pruned, " << pruning_stats.reachable_edges << " edges reachable (reachability pass "
+				 << pruning_stats.prepass_ns / 1000 << " microseconds)" << endl;
+	}
+
+	return 0;
+}
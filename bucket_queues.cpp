@@ -0,0 +1,94 @@
+#include "bucket_queues.h"
+#include <algorithm> // For min
+
+using namespace std;
+
+/**
+ * @brief Empties the queue for weights up to max_weight, keeping the bucket memory.
+ */
+void DialQueue::reset(int max_weight)
+{
+	if ((int)buckets_.size() != max_weight + 1)
+		buckets_.resize(max_weight + 1);
+	for (vector<int> &bucket : buckets_)
+		bucket.clear();
+	current_key_ = -1;
+	size_ = 0;
+}
+
+void DialQueue::push(long key, int node)
+{
+	if (current_key_ < 0)
+		current_key_ = key;
+	buckets_[key % buckets_.size()].push_back(node);
+	size_++;
+}
+
+/**
+ * @brief Removes an entry with the smallest key.
+ *
+ * @return false if the queue is empty.
+ */
+bool DialQueue::pop(long *key, int *node)
+{
+	if (size_ == 0)
+		return false;
+
+	size_t count = buckets_.size();
+	while (buckets_[current_key_ % count].empty())
+		current_key_++;
+
+	vector<int> &bucket = buckets_[current_key_ % count];
+	*node = bucket.back();
+	*key = current_key_;
+	bucket.pop_back();
+	size_--;
+	return true;
+}
+
+void RadixHeap::reset()
+{
+	for (int i = 0; i < BUCKETS; i++)
+		buckets_[i].clear();
+	last_key_ = 0;
+	size_ = 0;
+}
+
+void RadixHeap::push(long key, int node)
+{
+	buckets_[bucketOf(key, last_key_)].push_back({(unsigned long)key, node});
+	size_++;
+}
+
+/**
+ * @brief Removes an entry with the smallest key.
+ *
+ * @return false if the heap is empty.
+ */
+bool RadixHeap::pop(long *key, int *node)
+{
+	if (size_ == 0)
+		return false;
+
+	if (buckets_[0].empty())
+	{
+		int i = 1;
+		while (buckets_[i].empty())
+			i++;
+
+		unsigned long minimum = buckets_[i][0].first;
+		for (const pair<unsigned long, int> &entry : buckets_[i])
+			minimum = min(minimum, entry.first);
+
+		last_key_ = minimum;
+		for (const pair<unsigned long, int> &entry : buckets_[i])
+			buckets_[bucketOf(entry.first, last_key_)].push_back(entry);
+		buckets_[i].clear();
+	}
+
+	*key = (long)buckets_[0].back().first;
+	*node = buckets_[0].back().second;
+	buckets_[0].pop_back();
+	size_--;
+	return true;
+}
@@ -0,0 +1,58 @@
+#ifndef BUCKET_QUEUES_H
+#define BUCKET_QUEUES_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Monotone priority queues for Dijkstra with non-negative integer weights.
+//
+// Both only accept keys no smaller than the last key popped, which always holds for
+// Dijkstra, and both leave stale entries in place: the caller skips popped entries
+// whose key no longer matches the node's distance.
+
+// Dial's bucket queue: a ring of max_weight + 1 buckets, one per key. Every queued key
+// lies within max_weight of the last key popped, so each bucket holds a single key.
+// Push and pop are O(1) amortised, popping walks over empty buckets.
+class DialQueue
+{
+public:
+	DialQueue() : current_key_(-1), size_(0) {}
+
+	void reset(int max_weight);
+	void push(long key, int node);
+	bool pop(long *key, int *node);
+
+private:
+	std::vector<std::vector<int>> buckets_;
+	long current_key_;
+	size_t size_;
+};
+
+// Radix heap: bucket i holds the keys whose highest bit differing from the last key
+// popped is bit i - 1. Popping from an empty bucket 0 redistributes the next non-empty
+// bucket around its minimum, so each entry moves at most 64 times. Works for any range
+// of keys.
+class RadixHeap
+{
+public:
+	RadixHeap() : last_key_(0), size_(0) {}
+
+	void reset();
+	void push(long key, int node);
+	bool pop(long *key, int *node);
+
+private:
+	static const int BUCKETS = 65;
+
+	static int bucketOf(unsigned long key, unsigned long last_key)
+	{
+		return key == last_key ? 0 : 64 - __builtin_clzl(key ^ last_key);
+	}
+
+	std::vector<std::pair<unsigned long, int>> buckets_[BUCKETS];
+	unsigned long last_key_;
+	size_t size_;
+};
+
+#endif // BUCKET_QUEUES_H
@@ -0,0 +1,222 @@
+#include "checkpoint.h"
+#include "sssp_c_api.h"
+#include <cstdio>	  // For rename and FILE
+#include <cstdint>	  // For uint64_t
+#include <fcntl.h>	  // For open
+#include <unistd.h>	  // For fork, write and _exit
+#include <sys/mman.h> // For scratch memory in the writer process
+#include <sys/wait.h> // For waitpid
+
+using namespace std;
+
+/**
+ * @brief 64-bit FNV-1a style hash over the graph's size and edges.
+ *
+ * Stored in every checkpoint so that a checkpoint is only resumed on the graph it was
+ * taken from.
+ */
+unsigned long long graphChecksum(const Graph *graph)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	auto mix = [&hash](uint64_t value)
+	{
+		hash ^= value;
+		hash *= 1099511628211ULL;
+	};
+
+	mix(graph->no_of_nodes);
+	mix(graph->no_of_edges);
+	for (int i = 0; i < graph->no_of_edges; i++)
+	{
+		mix((uint32_t)graph->edge[i].source);
+		mix((uint32_t)graph->edge[i].destination);
+		mix((uint32_t)graph->edge[i].weight);
+	}
+	return hash;
+}
+
+static bool writeAll(int fd, const void *data, size_t bytes)
+{
+	const char *position = (const char *)data;
+	while (bytes > 0)
+	{
+		ssize_t n = write(fd, position, bytes);
+		if (n <= 0)
+			return false;
+		position += n;
+		bytes -= n;
+	}
+	return true;
+}
+
+/**
+ * @brief Writes one checkpoint file. Runs in the forked writer process, so it only uses
+ * system calls and mmap'd scratch memory.
+ */
+static bool writeCheckpointFile(const char *path, const CheckpointHeader &header, const long *distances,
+								const char *active, const Graph *graph)
+{
+	int no_of_nodes = header.no_of_nodes;
+	int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+		return false;
+
+	bool ok = writeAll(fd, &header, sizeof(header)) &&
+			  writeAll(fd, distances, (size_t)no_of_nodes * sizeof(long));
+
+	// active flags packed into bits, one stack buffer at a time
+	uint64_t words[1024];
+	for (int begin = 0; ok && begin < no_of_nodes; begin += 64 * 1024)
+	{
+		int count = 0;
+		for (int v = begin; v < no_of_nodes && v < begin + 64 * 1024; v += 64, count++)
+		{
+			words[count] = 0;
+			for (int bit = 0; bit < 64 && v + bit < no_of_nodes; bit++)
+			{
+				if (active[v + bit])
+					words[count] |= 1ULL << bit;
+			}
+		}
+		ok = writeAll(fd, words, count * sizeof(uint64_t));
+	}
+
+	// parent of v: the in-neighbour u with the smallest d(u) + w(u, v), as long as that
+	// does not exceed d(v); at convergence this is a shortest path tree
+	size_t scratch_bytes = (size_t)no_of_nodes * (sizeof(int) + sizeof(long));
+	char *scratch = (char *)mmap(NULL, scratch_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (ok && scratch != (char *)MAP_FAILED)
+	{
+		int *parents = (int *)scratch;
+		long *best = (long *)(scratch + (size_t)no_of_nodes * sizeof(int));
+		for (int v = 0; v < no_of_nodes; v++)
+		{
+			parents[v] = -1;
+			best[v] = distances[v];
+		}
+		for (int i = 0; i < graph->no_of_edges; i++)
+		{
+			const Edge &edge = graph->edge[i];
+			long candidate = distances[edge.source] + edge.weight;
+			if (distances[edge.source] < SSSP_INFINITY && edge.destination != header.source_node_id &&
+				(candidate < best[edge.destination] ||
+				 (candidate == best[edge.destination] && parents[edge.destination] < 0)))
+			{
+				best[edge.destination] = candidate;
+				parents[edge.destination] = edge.source;
+			}
+		}
+		ok = writeAll(fd, parents, (size_t)no_of_nodes * sizeof(int));
+	}
+	else
+		ok = false;
+
+	ok = fsync(fd) == 0 && ok;
+	close(fd);
+	return ok;
+}
+
+/**
+ * @brief Reads a checkpoint file written by CheckpointWriter.
+ *
+ * @return false if the file is missing, truncated or of another format.
+ */
+bool readCheckpoint(string path, Checkpoint *checkpoint)
+{
+	FILE *fp = fopen(path.c_str(), "rb");
+	if (fp == NULL)
+		return false;
+
+	CheckpointHeader &header = checkpoint->header;
+	bool ok = fread(&header, sizeof(header), 1, fp) == 1 && header.magic == CHECKPOINT_MAGIC &&
+			  header.format_version == CHECKPOINT_FORMAT_VERSION && header.no_of_nodes >= 0;
+
+	if (ok)
+	{
+		int no_of_nodes = header.no_of_nodes;
+		checkpoint->distances.resize(no_of_nodes);
+		ok = fread(checkpoint->distances.data(), sizeof(long), no_of_nodes, fp) == (size_t)no_of_nodes;
+
+		vector<uint64_t> words((no_of_nodes + 63) / 64);
+		ok = ok && fread(words.data(), sizeof(uint64_t), words.size(), fp) == words.size();
+		checkpoint->active.resize(no_of_nodes);
+		for (int v = 0; ok && v < no_of_nodes; v++)
+			checkpoint->active[v] = (words[v / 64] >> (v % 64)) & 1;
+
+		checkpoint->parents.resize(no_of_nodes);
+		ok = ok && fread(checkpoint->parents.data(), sizeof(int), no_of_nodes, fp) == (size_t)no_of_nodes;
+	}
+
+	fclose(fp);
+	return ok;
+}
+
+CheckpointWriter::CheckpointWriter() : running_(false), done_(true), completed_(0), child_(-1)
+{
+}
+
+CheckpointWriter::~CheckpointWriter()
+{
+	wait();
+}
+
+/**
+ * @brief Starts writing a checkpoint of the given state to path in the background.
+ *
+ * Must be called between rounds, while no worker thread touches the arrays.
+ *
+ * @return false if the previous checkpoint is still being written or fork failed, in
+ * which case this snapshot is skipped.
+ */
+bool CheckpointWriter::snapshot(string path, const CheckpointHeader &header, const long *distances,
+								const char *active, const Graph *graph)
+{
+	if (running_ && !done_)
+		return false;
+	wait();
+
+	path_ = path;
+	temporary_path_ = path + ".tmp";
+	const char *temporary_path = temporary_path_.c_str();
+
+	pid_t pid = fork();
+	if (pid < 0)
+		return false;
+	if (pid == 0)
+		_exit(writeCheckpointFile(temporary_path, header, distances, active, graph) ? 0 : 1);
+
+	child_ = pid;
+	done_ = false;
+	running_ = true;
+	pthread_create(&supervisor_, NULL, supervisorMain, this);
+	return true;
+}
+
+/**
+ * @brief Waits for the writer process and publishes the finished checkpoint.
+ */
+void *CheckpointWriter::supervisorMain(void *arg)
+{
+	CheckpointWriter *writer = (CheckpointWriter *)arg;
+
+	int status;
+	if (waitpid(writer->child_, &status, 0) == writer->child_ && WIFEXITED(status) && WEXITSTATUS(status) == 0 &&
+		rename(writer->temporary_path_.c_str(), writer->path_.c_str()) == 0)
+		writer->completed_++;
+	else
+		unlink(writer->temporary_path_.c_str());
+
+	writer->done_ = true;
+	return NULL;
+}
+
+/**
+ * @brief Blocks until the checkpoint in flight, if any, is written.
+ */
+void CheckpointWriter::wait()
+{
+	if (!running_)
+		return;
+	pthread_join(supervisor_, NULL);
+	running_ = false;
+}
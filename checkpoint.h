@@ -0,0 +1,75 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <pthread.h>
+#include <sys/types.h>
+#include <atomic>
+#include <string>
+#include <vector>
+#include "graph.h"
+
+const unsigned int CHECKPOINT_MAGIC = 0x4B434642; // "BFCK"
+const unsigned int CHECKPOINT_FORMAT_VERSION = 1;
+
+// start of a checkpoint file, followed by no_of_nodes distances (long), the active
+// vertex bitmap (one bit per node, in 64-bit words) and no_of_nodes parents (int)
+struct CheckpointHeader
+{
+	unsigned int magic;
+	unsigned int format_version;
+	int no_of_nodes;
+	int no_of_edges;
+	int source_node_id;
+	// relaxation rounds completed when the snapshot was taken
+	int round;
+	// identifies the graph the state belongs to, see graphChecksum
+	unsigned long long graph_checksum;
+};
+
+// a checkpoint read back from disk
+struct Checkpoint
+{
+	CheckpointHeader header;
+	std::vector<long> distances;
+	// nodes improved in the last completed round
+	std::vector<char> active;
+	// predecessor on the best known path, -1 for the source and unreached nodes
+	std::vector<int> parents;
+};
+
+unsigned long long graphChecksum(const Graph *graph);
+bool readCheckpoint(std::string path, Checkpoint *checkpoint);
+
+// Writes checkpoints without stalling the relaxation loop.
+//
+// snapshot() forks the process: the child sees a copy-on-write image of the distances and
+// active flags as they were between two rounds, derives the parent array from them and
+// writes the file, while the parent goes straight back to relaxing. A background thread
+// waits for the child and atomically renames the finished file over the previous
+// checkpoint, so a crash at any point leaves the last complete checkpoint behind. A
+// snapshot requested while the previous one is still being written is skipped.
+class CheckpointWriter
+{
+public:
+	CheckpointWriter();
+	~CheckpointWriter();
+
+	bool snapshot(std::string path, const CheckpointHeader &header, const long *distances, const char *active,
+				  const Graph *graph);
+	void wait();
+	// number of checkpoints completely written so far
+	int completed() const { return completed_; }
+
+private:
+	static void *supervisorMain(void *arg);
+
+	pthread_t supervisor_;
+	bool running_;
+	std::atomic<bool> done_;
+	std::atomic<int> completed_;
+	pid_t child_;
+	std::string path_;
+	std::string temporary_path_;
+};
+
+#endif // CHECKPOINT_H
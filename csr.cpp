@@ -0,0 +1,106 @@
+#include "csr.h"
+#include <cstdlib> // For malloc and free
+#include <cstring> // For memset
+
+/**
+ * @brief Groups the edges of a graph by one endpoint with a counting sort.
+ *
+ * Edges keep their input order within each group.
+ *
+ * @param by_destination Group by destination (CSC) instead of by source (CSR).
+ * @param arena Arena to allocate the arrays from, or NULL for malloc. If the arena cannot
+ * map another chunk the arrays are malloc'd as well.
+ * @return false if there was no memory for the arrays, the layout is left empty then.
+ */
+static bool buildCompressed(const Graph *graph, int no_of_nodes, bool by_destination, CsrGraph *csr, Arena *arena)
+{
+	int no_of_edges = graph->no_of_edges;
+
+	csr->no_of_nodes = no_of_nodes;
+	csr->no_of_edges = no_of_edges;
+	csr->arena_backed = false;
+	if (arena != NULL)
+	{
+		csr->offsets = arena->allocateArray<int>((size_t)no_of_nodes + 1);
+		csr->neighbours = arena->allocateArray<int>(no_of_edges);
+		csr->weights = arena->allocateArray<int>(no_of_edges);
+		csr->arena_backed = csr->offsets != NULL && csr->neighbours != NULL && csr->weights != NULL;
+	}
+	if (!csr->arena_backed)
+	{
+		csr->offsets = (int *)malloc(((size_t)no_of_nodes + 1) * sizeof(int));
+		csr->neighbours = (int *)malloc((size_t)no_of_edges * sizeof(int));
+		csr->weights = (int *)malloc((size_t)no_of_edges * sizeof(int));
+		if (csr->offsets == NULL || csr->neighbours == NULL || csr->weights == NULL)
+		{
+			freeCsr(csr);
+			return false;
+		}
+	}
+
+	memset(csr->offsets, 0, ((size_t)no_of_nodes + 1) * sizeof(int));
+	for (int i = 0; i < no_of_edges; i++)
+	{
+		const Edge &edge = graph->edge[i];
+		csr->offsets[(by_destination ? edge.destination : edge.source) + 1]++;
+	}
+	for (int v = 0; v < no_of_nodes; v++)
+		csr->offsets[v + 1] += csr->offsets[v];
+
+	// offsets[v] is used as the insert position of node v and shifted back afterwards
+	for (int i = 0; i < no_of_edges; i++)
+	{
+		const Edge &edge = graph->edge[i];
+		int key = by_destination ? edge.destination : edge.source;
+		int position = csr->offsets[key]++;
+		csr->neighbours[position] = by_destination ? edge.source : edge.destination;
+		csr->weights[position] = edge.weight;
+	}
+	for (int v = no_of_nodes; v > 0; v--)
+		csr->offsets[v] = csr->offsets[v - 1];
+	csr->offsets[0] = 0;
+	return true;
+}
+
+/**
+ * @brief Builds the outgoing edge lists of every node.
+ *
+ * @param graph The edge list.
+ * @param no_of_nodes Number of nodes, larger than every node id of the graph.
+ * @param csr The layout to fill, released with freeCsr.
+ * @param arena Arena to allocate the arrays from, or NULL for malloc.
+ * @return false if there was no memory for the layout.
+ */
+bool buildCsr(const Graph *graph, int no_of_nodes, CsrGraph *csr, Arena *arena)
+{
+	return buildCompressed(graph, no_of_nodes, false, csr, arena);
+}
+
+/**
+ * @brief Builds the incoming edge lists of every node.
+ *
+ * @param graph The edge list.
+ * @param no_of_nodes Number of nodes, larger than every node id of the graph.
+ * @param csc The layout to fill, released with freeCsr.
+ * @param arena Arena to allocate the arrays from, or NULL for malloc.
+ * @return false if there was no memory for the layout.
+ */
+bool buildCsc(const Graph *graph, int no_of_nodes, CsrGraph *csc, Arena *arena)
+{
+	return buildCompressed(graph, no_of_nodes, true, csc, arena);
+}
+
+void freeCsr(CsrGraph *csr)
+{
+	if (!csr->arena_backed)
+	{
+		free(csr->offsets);
+		free(csr->neighbours);
+		free(csr->weights);
+	}
+	csr->offsets = NULL;
+	csr->neighbours = NULL;
+	csr->weights = NULL;
+	csr->no_of_nodes = 0;
+	csr->no_of_edges = 0;
+}
@@ -0,0 +1,27 @@
+#ifndef CSR_H
+#define CSR_H
+
+#include "graph.h"
+#include "arena.h"
+
+// Compressed sparse row layout of a graph.
+//
+// The edges of node v are [offsets[v], offsets[v + 1]) in neighbours and weights. Built
+// from the source side (CSR) neighbours are destinations; built from the destination
+// side (CSC) neighbours are the sources of the incoming edges.
+struct CsrGraph
+{
+	int no_of_nodes;
+	int no_of_edges;
+	int *offsets;
+	int *neighbours;
+	int *weights;
+	// arrays allocated from an arena are released with the arena, not by freeCsr
+	bool arena_backed;
+};
+
+bool buildCsr(const Graph *graph, int no_of_nodes, CsrGraph *csr, Arena *arena = NULL);
+bool buildCsc(const Graph *graph, int no_of_nodes, CsrGraph *csc, Arena *arena = NULL);
+void freeCsr(CsrGraph *csr);
+
+#endif // CSR_H
@@ -0,0 +1,30 @@
+#ifndef DISTANCE_ATOMICS_H
+#define DISTANCE_ATOMICS_H
+
+#include <atomic>
+
+// Race-free accesses to a plain distance array shared by several relaxing threads.
+
+inline long loadDistance(long *slot)
+{
+	return std::atomic_ref<long>(*slot).load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Lowers *slot to value if value is smaller.
+ *
+ * @return true if this call lowered the distance.
+ */
+inline bool atomicMinDistance(long *slot, long value)
+{
+	std::atomic_ref<long> distance(*slot);
+	long current = distance.load(std::memory_order_relaxed);
+	while (value < current)
+	{
+		if (distance.compare_exchange_weak(current, value, std::memory_order_relaxed))
+			return true;
+	}
+	return false;
+}
+
+#endif // DISTANCE_ATOMICS_H
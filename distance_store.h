@@ -0,0 +1,92 @@
+#ifndef DISTANCE_STORE_H
+#define DISTANCE_STORE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include "arena.h"
+
+// Distance array of a single source solve, kept on the heap or in an arena and reused
+// across solves, so large graphs neither overflow the stack nor reallocate per query.
+//
+// fill() re-initialises the whole array for every solve. That costs one pass over the
+// nodes, less than a single relaxation round, and keeps the kernels indexing a plain
+// array. Distance is int32_t for the SIMD kernels and long where sums of many weights
+// need 64 bits.
+template <typename Distance>
+class DistanceStore
+{
+public:
+	// distance of nodes not reached from the source
+	static constexpr Distance INFINITE_DISTANCE = std::numeric_limits<int>::max() - 100;
+
+	DistanceStore() : values_(NULL), no_of_nodes_(0), owns_memory_(false) {}
+
+	/**
+	 * @brief Allocates the store for no_of_nodes nodes.
+	 *
+	 * @param arena Arena to allocate from, or NULL for the heap.
+	 */
+	explicit DistanceStore(int no_of_nodes, Arena *arena = NULL) : DistanceStore()
+	{
+		allocate(no_of_nodes, arena);
+	}
+
+	~DistanceStore()
+	{
+		release();
+	}
+
+	DistanceStore(const DistanceStore &) = delete;
+	DistanceStore &operator=(const DistanceStore &) = delete;
+
+	/**
+	 * @brief (Re)allocates the store, falling back to the heap if the arena is exhausted.
+	 */
+	void allocate(int no_of_nodes, Arena *arena = NULL)
+	{
+		release();
+		if (arena != NULL)
+			values_ = arena->allocateArray<Distance>(no_of_nodes);
+		if (values_ == NULL)
+		{
+			values_ = (Distance *)malloc((size_t)no_of_nodes * sizeof(Distance));
+			owns_memory_ = true;
+		}
+		no_of_nodes_ = no_of_nodes;
+	}
+
+	/**
+	 * @brief Starts a new solve: writes infinity to every node and 0 to the source.
+	 *
+	 * @return The distance array.
+	 */
+	Distance *fill(int source_node_id)
+	{
+		std::fill(values_, values_ + no_of_nodes_, INFINITE_DISTANCE);
+		values_[source_node_id] = 0;
+		return values_;
+	}
+
+	int size() const { return no_of_nodes_; }
+
+private:
+	void release()
+	{
+		if (owns_memory_)
+			free(values_);
+		values_ = NULL;
+		no_of_nodes_ = 0;
+		owns_memory_ = false;
+	}
+
+	Distance *values_;
+	int no_of_nodes_;
+	bool owns_memory_;
+};
+
+typedef DistanceStore<int32_t> DistanceStore32;
+typedef DistanceStore<long> DistanceStore64;
+
+#endif // DISTANCE_STORE_H
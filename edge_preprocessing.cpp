@@ -0,0 +1,186 @@
+#include "edge_preprocessing.h"
+#include <algorithm>	  // For max and min
+#include <cstdlib>	  // For malloc, realloc and free
+#include <functional> // For the group visitor
+#include <vector>	  // For per-thread histograms and counters
+
+using namespace std;
+
+// bits sorted per radix pass
+static const int RADIX_BITS = 8;
+static const int RADIX_BUCKETS = 1 << RADIX_BITS;
+
+static int bitsNeeded(unsigned int value)
+{
+	return value == 0 ? 0 : 32 - __builtin_clz(value);
+}
+
+static bool sameEndpoints(const Edge &a, const Edge &b)
+{
+	return a.source == b.source && a.destination == b.destination;
+}
+
+/**
+ * @brief Sorts edges by (source, destination) with a parallel LSD radix sort.
+ *
+ * The key is the source shifted above the destination, with only as many bits as the
+ * largest node id needs, so a graph with fewer than 65536 nodes sorts in four passes.
+ * Every pass counts digits per thread over a contiguous block, turns the counts into
+ * per-thread write positions ordered by digit and then by thread, and scatters, which
+ * keeps each pass stable.
+ *
+ * @return The buffer holding the sorted edges, either edges or scratch.
+ */
+static Edge *radixSortEdges(Edge *edges, Edge *scratch, int no_of_edges, ThreadPool &pool)
+{
+	int num_threads = pool.size();
+	int bsize = (no_of_edges + num_threads - 1) / num_threads;
+
+	vector<unsigned int> largest(num_threads, 0);
+	pool.run([&](int tid)
+	{
+		unsigned int local = 0;
+		for (int i = tid * bsize; i < min(no_of_edges, (tid + 1) * bsize); i++)
+			local = max(local, (unsigned int)max(edges[i].source, edges[i].destination));
+		largest[tid] = local;
+	});
+	int id_bits = bitsNeeded(*max_element(largest.begin(), largest.end()));
+	int key_bits = 2 * id_bits;
+
+	vector<int> counts((size_t)num_threads * RADIX_BUCKETS);
+	Edge *input = edges, *output = scratch;
+	for (int shift = 0; shift < key_bits; shift += RADIX_BITS)
+	{
+		auto digit = [shift, id_bits](const Edge &edge)
+		{
+			unsigned long key = ((unsigned long)edge.source << id_bits) | (unsigned int)edge.destination;
+			return (int)((key >> shift) & (RADIX_BUCKETS - 1));
+		};
+
+		pool.run([&](int tid)
+		{
+			int *local = &counts[(size_t)tid * RADIX_BUCKETS];
+			fill(local, local + RADIX_BUCKETS, 0);
+			for (int i = tid * bsize; i < min(no_of_edges, (tid + 1) * bsize); i++)
+				local[digit(input[i])]++;
+		});
+
+		int position = 0;
+		for (int d = 0; d < RADIX_BUCKETS; d++)
+		{
+			for (int tn = 0; tn < num_threads; tn++)
+			{
+				int count = counts[(size_t)tn * RADIX_BUCKETS + d];
+				counts[(size_t)tn * RADIX_BUCKETS + d] = position;
+				position += count;
+			}
+		}
+
+		pool.run([&](int tid)
+		{
+			int *local = &counts[(size_t)tid * RADIX_BUCKETS];
+			for (int i = tid * bsize; i < min(no_of_edges, (tid + 1) * bsize); i++)
+				output[local[digit(input[i])]++] = input[i];
+		});
+
+		swap(input, output);
+	}
+
+	return input;
+}
+
+/**
+ * @brief Removes the edges that can never be part of a shortest path.
+ *
+ * Sorts the edges by (source, destination), drops self-loops with non-negative weight
+ * and collapses every group of parallel edges into one edge with the smallest weight.
+ * Negative self-loops are kept, they are negative cycles the solver has to report.
+ * Distances are unchanged, but every relaxation round streams fewer edges, and the sorted
+ * order makes the reads of source distances sequential.
+ *
+ * The node count of the graph is left as it is, even if the largest id only appeared on
+ * a removed self-loop.
+ *
+ * @param graph The graph to simplify, its edge array is replaced by a malloc'd one.
+ * @param pool Threads to sort and compact with.
+ * @param reduction Receives the edge counts before and after.
+ */
+void simplifyGraph(Graph *graph, ThreadPool &pool, EdgeReduction *reduction)
+{
+	int no_of_edges = graph->no_of_edges;
+	reduction->input_edges = no_of_edges;
+	reduction->output_edges = no_of_edges;
+	reduction->self_loops = 0;
+	reduction->parallel_edges = 0;
+
+	Edge *scratch = (Edge *)malloc((size_t)no_of_edges * sizeof(Edge));
+	if (no_of_edges == 0 || scratch == NULL)
+	{
+		free(scratch);
+		return;
+	}
+
+	Edge *sorted = radixSortEdges(graph->edge, scratch, no_of_edges, pool);
+	Edge *compacted = sorted == scratch ? graph->edge : scratch;
+
+	// each thread owns the groups of parallel edges that start in its block, a group may
+	// run past the end of the block
+	int num_threads = pool.size();
+	int bsize = (no_of_edges + num_threads - 1) / num_threads;
+	vector<int> kept(num_threads + 1, 0), self_loops(num_threads, 0), parallel_edges(num_threads, 0);
+	auto forEachGroup = [&](int tid, const function<void(const Edge &, int)> &visit)
+	{
+		int begin = min(no_of_edges, tid * bsize);
+		int end = min(no_of_edges, (tid + 1) * bsize);
+		while (begin < end && begin > 0 && sameEndpoints(sorted[begin - 1], sorted[begin]))
+			begin++;
+
+		for (int i = begin; i < end;)
+		{
+			Edge edge = sorted[i];
+			int j = i + 1;
+			for (; j < no_of_edges && sameEndpoints(sorted[j], edge); j++)
+				edge.weight = min(edge.weight, sorted[j].weight);
+			visit(edge, j - i);
+			i = j;
+		}
+	};
+
+	pool.run([&](int tid)
+	{
+		forEachGroup(tid, [&](const Edge &edge, int group_size)
+		{
+			if (edge.source == edge.destination && edge.weight >= 0)
+				self_loops[tid] += group_size;
+			else
+			{
+				kept[tid + 1]++;
+				parallel_edges[tid] += group_size - 1;
+			}
+		});
+	});
+
+	for (int tn = 0; tn < num_threads; tn++)
+	{
+		kept[tn + 1] += kept[tn];
+		reduction->self_loops += self_loops[tn];
+		reduction->parallel_edges += parallel_edges[tn];
+	}
+
+	pool.run([&](int tid)
+	{
+		int position = kept[tid];
+		forEachGroup(tid, [&](const Edge &edge, int)
+		{
+			if (edge.source != edge.destination || edge.weight < 0)
+				compacted[position++] = edge;
+		});
+	});
+
+	free(sorted);
+	int output_edges = kept[num_threads];
+	Edge *shrunk = (Edge *)realloc(compacted, max(1, output_edges) * sizeof(Edge));
+	graph->edge = shrunk != NULL ? shrunk : compacted;
+	graph->no_of_edges = output_edges;
+	reduction->output_edges = output_edges;
+}
@@ -0,0 +1,20 @@
+#ifndef EDGE_PREPROCESSING_H
+#define EDGE_PREPROCESSING_H
+
+#include "graph.h"
+#include "thread_pool.h"
+
+// what simplifyGraph removed from an edge list
+struct EdgeReduction
+{
+	int input_edges;
+	int output_edges;
+	// self-loops with non-negative weight, which can never shorten a path
+	int self_loops;
+	// edges merged into a parallel edge with the same endpoints and a smaller weight
+	int parallel_edges;
+};
+
+void simplifyGraph(Graph *graph, ThreadPool &pool, EdgeReduction *reduction);
+
+#endif // EDGE_PREPROCESSING_H
@@ -0,0 +1,140 @@
+#include <iostream>			// For input/output stream
+#include <string>			// For string operations
+#include <chrono>			// For high resolution timing
+#include <cstdlib>			// For atoi and strtoull
+#include <climits>			// For INT_MAX
+#include "graph.h"			 // For graph data structure
+#include "graph_generator.h" // For synthetic graph generators
+
+using namespace std;
+
+/**
+ * @brief Prints the command line usage of the generator.
+ */
+void printUsage(const char *program)
+{
+	cout << "Usage: " << program << " <rmat|grid|chain> [options] --output <file.mtx|file.bin>" << endl
+		 << "  rmat:  --scale S --edge-factor F     (2^S nodes, F * 2^S edges)" << endl
+		 << "  grid:  --rows R --cols C" << endl
+		 << "  chain: --length N" << endl
+		 << "  --min-weight W --max-weight W        weight range (default 1..100)" << endl
+		 << "  --negative P                         reweight with potentials in [0, P]," << endl
+		 << "                                       negative weights but no negative cycles" << endl
+		 << "  --seed N --threads N" << endl;
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 2)
+	{
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	string kind = argv[1];
+	GeneratorOptions options = defaultGeneratorOptions();
+	int scale = 16, edge_factor = 16, rows = 256, cols = 256, length = 1 << 16, negative = 0;
+	string output_path;
+
+	// every option takes a value, a trailing flag without one is a usage error
+	if ((argc - 2) % 2 != 0)
+	{
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	for (int i = 2; i + 1 < argc; i += 2)
+	{
+		string option = argv[i];
+		const char *value = argv[i + 1];
+
+		if (option == "--scale")
+			scale = atoi(value);
+		else if (option == "--edge-factor")
+			edge_factor = atoi(value);
+		else if (option == "--rows")
+			rows = atoi(value);
+		else if (option == "--cols")
+			cols = atoi(value);
+		else if (option == "--length")
+			length = atoi(value);
+		else if (option == "--min-weight")
+			options.min_weight = atoi(value);
+		else if (option == "--max-weight")
+			options.max_weight = atoi(value);
+		else if (option == "--negative")
+			negative = atoi(value);
+		else if (option == "--seed")
+			options.seed = strtoull(value, NULL, 10);
+		else if (option == "--threads")
+			options.num_threads = atoi(value);
+		else if (option == "--output")
+			output_path = value;
+		else
+		{
+			printUsage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (output_path.empty() || options.min_weight > options.max_weight)
+	{
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	// node ids and edge counts are ints, reject sizes that would overflow them
+	bool valid_size;
+	if (kind == "rmat")
+		valid_size = scale >= 1 && scale <= 30 && edge_factor >= 1 && ((long long)edge_factor << scale) <= INT_MAX;
+	else if (kind == "grid")
+		valid_size = rows >= 1 && cols >= 1 && 4LL * rows * cols <= INT_MAX;
+	else if (kind == "chain")
+		valid_size = length >= 1;
+	else
+		valid_size = false;
+
+	if (!valid_size)
+	{
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	auto t1 = chrono::high_resolution_clock::now();
+
+	Graph *graph;
+	if (kind == "rmat")
+		graph = generateRmatGraph(scale, edge_factor, options);
+	else if (kind == "grid")
+		graph = generateGridGraph(rows, cols, options);
+	else
+		graph = generateChainGraph(length, options);
+
+	if (graph == NULL)
+	{
+		cout << "Could not allocate the " << kind << " graph" << endl;
+		return 1;
+	}
+
+	if (negative > 0)
+		applyNegativeWeights(graph, negative, options.seed);
+
+	auto t2 = chrono::high_resolution_clock::now();
+	auto duration_1 = chrono::duration_cast<chrono::microseconds>(t2 - t1).count();
+	cout << "Generated " << kind << " graph with " << graph->no_of_nodes << " nodes and "
+		 << graph->no_of_edges << " edges in " << duration_1 << " microseconds" << endl;
+
+	bool binary = output_path.size() > 4 && output_path.compare(output_path.size() - 4, 4, ".bin") == 0;
+	bool written = binary ? writeGraphBinary(graph, output_path) : writeGraphMtx(graph, output_path);
+	if (!written)
+	{
+		cout << "Could not write graph to " << output_path << endl;
+		freeGraph(graph);
+		return 1;
+	}
+
+	cout << "Graph written to " << output_path << endl;
+	freeGraph(graph);
+
+	return 0;
+}
@@ -1,6 +1,8 @@
 #include "graph.h"
 #include <fstream>
 #include <sstream>
+#include <cstdio>
+#include <cstdlib>
 
 using namespace std;
 
@@ -19,6 +21,10 @@ using namespace std;
 struct Graph *readGraph(string input_graph_path)
 {
     struct Graph *graph = (struct Graph *)malloc(sizeof(struct Graph));
+    // a file that cannot be opened leaves an empty graph without an edge array
+    graph->no_of_nodes = 0;
+    graph->no_of_edges = 0;
+    graph->edge = NULL;
 
     // reading input data file
     ifstream myfile(input_graph_path);
@@ -81,4 +87,131 @@ struct Graph *readGraph(string input_graph_path)
     }
 
     return graph;
-}
\ No newline at end of file
+}
+
+// magic number identifying the binary edge list format ("BFSG")
+static const int BINARY_GRAPH_MAGIC = 0x47534642;
+
+/**
+ * @brief Reads a graph stored in the binary edge list format.
+ *
+ * The binary format starts with a magic number, the number of nodes and the number of
+ * edges (all 32-bit integers), followed by the raw array of Edge structures. It is the
+ * format written by writeGraphBinary and loads much faster than the text .mtx format.
+ *
+ * @param input_graph_path The path to the binary graph file.
+ * @return A pointer to the graph read from the file, or NULL if the file could not be read.
+ */
+struct Graph *readGraphBinary(string input_graph_path)
+{
+    ifstream myfile(input_graph_path, ios::binary);
+    if (!myfile.is_open())
+    {
+        return NULL;
+    }
+
+    int header[3];
+    myfile.read((char *)header, sizeof(header));
+    if (!myfile || header[0] != BINARY_GRAPH_MAGIC)
+    {
+        return NULL;
+    }
+
+    struct Graph *graph = (struct Graph *)malloc(sizeof(struct Graph));
+    graph->no_of_nodes = header[1];
+    graph->no_of_edges = header[2];
+    graph->edge = (struct Edge *)malloc((size_t)graph->no_of_edges * sizeof(struct Edge));
+    myfile.read((char *)graph->edge, (size_t)graph->no_of_edges * sizeof(struct Edge));
+    if (!myfile)
+    {
+        free(graph->edge);
+        free(graph);
+        return NULL;
+    }
+
+    return graph;
+}
+
+/**
+ * @brief Reads a graph, choosing the binary or the .mtx reader from the file extension.
+ *
+ * @param input_graph_path The path to a ".bin" binary graph or a Matrix Market file.
+ * @return A pointer to the graph read from the file.
+ */
+struct Graph *loadGraph(string input_graph_path)
+{
+    size_t length = input_graph_path.size();
+    if (length > 4 && input_graph_path.compare(length - 4, 4, ".bin") == 0)
+    {
+        return readGraphBinary(input_graph_path);
+    }
+    return readGraph(input_graph_path);
+}
+
+/**
+ * @brief Writes a graph to a file in Matrix Market coordinate format.
+ *
+ * The header line holds the number of nodes (as both rows and columns) and the number
+ * of edges, followed by one "source destination weight" line per edge, which is the
+ * layout readGraph expects. Node ids are written 1-based, like higgs-twitter.mtx.
+ *
+ * @param graph The graph to write.
+ * @param output_graph_path The path of the file to create.
+ * @return true if the whole graph was written, false otherwise.
+ */
+bool writeGraphMtx(const struct Graph *graph, string output_graph_path)
+{
+    FILE *fp = fopen(output_graph_path.c_str(), "w");
+    if (fp == NULL)
+    {
+        return false;
+    }
+
+    fprintf(fp, "%%%%MatrixMarket matrix coordinate integer general\n");
+    fprintf(fp, "%d %d %d\n", graph->no_of_nodes, graph->no_of_nodes, graph->no_of_edges);
+    for (int i = 0; i < graph->no_of_edges; i++)
+    {
+        fprintf(fp, "%d %d %d\n", graph->edge[i].source + 1, graph->edge[i].destination + 1, graph->edge[i].weight);
+    }
+
+    bool ok = !ferror(fp);
+    fclose(fp);
+    return ok;
+}
+
+/**
+ * @brief Writes a graph to a file in the binary edge list format read by readGraphBinary.
+ *
+ * @param graph The graph to write.
+ * @param output_graph_path The path of the file to create.
+ * @return true if the whole graph was written, false otherwise.
+ */
+bool writeGraphBinary(const struct Graph *graph, string output_graph_path)
+{
+    ofstream myfile(output_graph_path, ios::binary);
+    if (!myfile.is_open())
+    {
+        return false;
+    }
+
+    int header[3] = {BINARY_GRAPH_MAGIC, graph->no_of_nodes, graph->no_of_edges};
+    myfile.write((const char *)header, sizeof(header));
+    myfile.write((const char *)graph->edge, (size_t)graph->no_of_edges * sizeof(struct Edge));
+
+    return (bool)myfile;
+}
+
+/**
+ * @brief Releases a graph returned by readGraph, readGraphBinary or one of the generators.
+ *
+ * @param graph The graph to release, may be NULL.
+ */
+void freeGraph(struct Graph *graph)
+{
+    if (graph == NULL)
+    {
+        return;
+    }
+    free(graph->edge);
+    free(graph);
+}
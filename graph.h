@@ -17,7 +17,12 @@ struct Graph
     Edge *edge;
 };
 
-// Function declaration
+// Function declarations
 Graph* readGraph(std::string input_graph_path);
+Graph* readGraphBinary(std::string input_graph_path);
+Graph* loadGraph(std::string input_graph_path);
+bool writeGraphMtx(const Graph *graph, std::string output_graph_path);
+bool writeGraphBinary(const Graph *graph, std::string output_graph_path);
+void freeGraph(Graph *graph);
 
 #endif // GRAPH_H
\ No newline at end of file
@@ -0,0 +1,309 @@
+#include "graph_generator.h"
+#include <pthread.h> // For multithreading operations
+#include <random>	 // For the vertex permutation of R-MAT graphs
+#include <vector>	 // For vector data structure
+#include <cstdlib>	 // For malloc
+#include <cstdint>	 // For fixed width integers
+#include <algorithm> // For shuffle and min
+
+using namespace std;
+
+// Graph500 R-MAT quadrant probabilities, d = 1 - a - b - c
+static const double RMAT_A = 0.57;
+static const double RMAT_B = 0.19;
+static const double RMAT_C = 0.19;
+
+// number of edges generated from one seed, keeps the output independent of the thread count
+static const long long EDGES_PER_BLOCK = 1 << 16;
+
+// work description handed to every generator thread
+struct GeneratorTask
+{
+	Graph *graph;
+	GeneratorOptions options;
+	long long begin;
+	long long end;
+	// generator specific parameters
+	int scale;
+	int cols;
+	const int *permutation;
+};
+
+/**
+ * @brief Returns default generator options: weights in [1, 100], seed 1 and 4 threads.
+ */
+GeneratorOptions defaultGeneratorOptions()
+{
+	GeneratorOptions options;
+	options.min_weight = 1;
+	options.max_weight = 100;
+	options.seed = 1;
+	options.num_threads = 4;
+	return options;
+}
+
+/**
+ * @brief Counter based random number generator (splitmix64).
+ *
+ * Every random value is a pure function of the seed and a counter, so edges can be
+ * generated by any thread in any order and the graph still only depends on the seed.
+ */
+static uint64_t randomAt(uint64_t seed, uint64_t counter)
+{
+	uint64_t z = seed + (counter + 1) * 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+static double randomUnitAt(uint64_t seed, uint64_t counter)
+{
+	return (randomAt(seed, counter) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static int randomWeightAt(const GeneratorOptions &options, uint64_t counter)
+{
+	uint64_t range = (uint64_t)((long long)options.max_weight - options.min_weight + 1);
+	return options.min_weight + (int)(randomAt(options.seed ^ 0x5bd1e995ULL, counter) % range);
+}
+
+static Graph *allocateGraph(int no_of_nodes, long long no_of_edges)
+{
+	Graph *graph = (Graph *)malloc(sizeof(Graph));
+	if (graph == NULL)
+		return NULL;
+	graph->no_of_nodes = no_of_nodes;
+	graph->no_of_edges = (int)no_of_edges;
+	// one spare edge keeps malloc(0) of an edgeless chain from looking like a failure
+	graph->edge = (Edge *)malloc((size_t)(no_of_edges > 0 ? no_of_edges : 1) * sizeof(Edge));
+	if (graph->edge == NULL)
+	{
+		free(graph);
+		return NULL;
+	}
+	return graph;
+}
+
+/**
+ * @brief Splits [0, work) into blocks and runs worker on them with options.num_threads pthreads.
+ */
+static void runGeneratorThreads(GeneratorTask task, long long work, void *(*worker)(void *))
+{
+	int num_threads = task.options.num_threads > 0 ? task.options.num_threads : 1;
+	long long no_of_blocks = (work + EDGES_PER_BLOCK - 1) / EDGES_PER_BLOCK;
+	long long blocks_per_thread = (no_of_blocks + num_threads - 1) / num_threads;
+
+	vector<pthread_t> threads(num_threads);
+	vector<GeneratorTask> tasks(num_threads, task);
+
+	for (int tn = 0; tn < num_threads; tn++)
+	{
+		tasks[tn].begin = min(work, tn * blocks_per_thread * EDGES_PER_BLOCK);
+		tasks[tn].end = min(work, (tn + 1) * blocks_per_thread * EDGES_PER_BLOCK);
+		pthread_create(&threads[tn], NULL, worker, &tasks[tn]);
+	}
+
+	for (int tn = 0; tn < num_threads; tn++)
+		pthread_join(threads[tn], NULL);
+}
+
+static void *generateRmatEdges(void *arg)
+{
+	GeneratorTask *task = (GeneratorTask *)arg;
+
+	for (long long e = task->begin; e < task->end; e++)
+	{
+		int source = 0, destination = 0;
+
+		// descend the adjacency matrix one quadrant per bit
+		for (int bit = 0; bit < task->scale; bit++)
+		{
+			double r = randomUnitAt(task->options.seed, (uint64_t)e * task->scale + bit);
+			source <<= 1;
+			destination <<= 1;
+			if (r < RMAT_A)
+			{
+				// top left quadrant
+			}
+			else if (r < RMAT_A + RMAT_B)
+			{
+				destination |= 1;
+			}
+			else if (r < RMAT_A + RMAT_B + RMAT_C)
+			{
+				source |= 1;
+			}
+			else
+			{
+				source |= 1;
+				destination |= 1;
+			}
+		}
+
+		task->graph->edge[e].source = task->permutation[source];
+		task->graph->edge[e].destination = task->permutation[destination];
+		task->graph->edge[e].weight = randomWeightAt(task->options, e);
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Generates an R-MAT (Graph500 Kronecker) graph with a power-law degree distribution.
+ *
+ * The graph has 2^scale nodes and edge_factor * 2^scale directed edges. Vertex ids are
+ * randomly permuted, as in Graph500, so that high degree vertices are not clustered at
+ * low ids. Duplicate edges and self loops are kept, like in real edge lists.
+ *
+ * @param scale Base two logarithm of the number of nodes.
+ * @param edge_factor Average number of edges per node.
+ * @param options Weight range, seed and thread count.
+ * @return A pointer to the generated graph, or NULL if it could not be allocated.
+ */
+Graph *generateRmatGraph(int scale, int edge_factor, GeneratorOptions options)
+{
+	int no_of_nodes = 1 << scale;
+	long long no_of_edges = (long long)edge_factor * no_of_nodes;
+	Graph *graph = allocateGraph(no_of_nodes, no_of_edges);
+	if (graph == NULL)
+		return NULL;
+
+	vector<int> permutation(no_of_nodes);
+	for (int i = 0; i < no_of_nodes; i++)
+		permutation[i] = i;
+	mt19937_64 rng(options.seed);
+	shuffle(permutation.begin(), permutation.end(), rng);
+
+	GeneratorTask task = {graph, options, 0, 0, scale, 0, permutation.data()};
+	runGeneratorThreads(task, no_of_edges, generateRmatEdges);
+
+	return graph;
+}
+
+static void *generateGridEdges(void *arg)
+{
+	GeneratorTask *task = (GeneratorTask *)arg;
+	int cols = task->cols;
+
+	// every node owns up to four outgoing edge slots: right, left, down, up
+	for (long long e = task->begin; e < task->end; e++)
+	{
+		int node = (int)(e / 4);
+		int direction = (int)(e % 4);
+		int row = node / cols;
+		int col = node % cols;
+		int rows = task->graph->no_of_nodes / cols;
+
+		int neighbour = -1;
+		if (direction == 0 && col + 1 < cols)
+			neighbour = node + 1;
+		else if (direction == 1 && col > 0)
+			neighbour = node - 1;
+		else if (direction == 2 && row + 1 < rows)
+			neighbour = node + cols;
+		else if (direction == 3 && row > 0)
+			neighbour = node - cols;
+
+		// missing border edges become zero weight self loops, dropped below
+		task->graph->edge[e].source = node;
+		task->graph->edge[e].destination = neighbour < 0 ? node : neighbour;
+		task->graph->edge[e].weight = neighbour < 0 ? 0 : randomWeightAt(task->options, e);
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Generates a rows x cols 2D grid with edges in both directions between neighbours.
+ *
+ * Grids have a diameter of rows + cols - 2, which makes them the worst case for the
+ * number of Bellman-Ford rounds.
+ *
+ * @param rows Number of grid rows.
+ * @param cols Number of grid columns.
+ * @param options Weight range, seed and thread count.
+ * @return A pointer to the generated graph, or NULL if it could not be allocated.
+ */
+Graph *generateGridGraph(int rows, int cols, GeneratorOptions options)
+{
+	int no_of_nodes = rows * cols;
+	long long no_of_slots = 4LL * no_of_nodes;
+	Graph *graph = allocateGraph(no_of_nodes, no_of_slots);
+	if (graph == NULL)
+		return NULL;
+
+	GeneratorTask task = {graph, options, 0, 0, 0, cols, NULL};
+	runGeneratorThreads(task, no_of_slots, generateGridEdges);
+
+	// compact away the border slots
+	long long count = 0;
+	for (long long e = 0; e < no_of_slots; e++)
+	{
+		if (graph->edge[e].source != graph->edge[e].destination)
+			graph->edge[count++] = graph->edge[e];
+	}
+	graph->no_of_edges = (int)count;
+
+	return graph;
+}
+
+static void *generateChainEdges(void *arg)
+{
+	GeneratorTask *task = (GeneratorTask *)arg;
+
+	for (long long e = task->begin; e < task->end; e++)
+	{
+		task->graph->edge[e].source = (int)e;
+		task->graph->edge[e].destination = (int)e + 1;
+		task->graph->edge[e].weight = randomWeightAt(task->options, e);
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Generates a chain 0 -> 1 -> ... -> length - 1.
+ *
+ * The edges are stored in order, so a single in-order Bellman-Ford sweep already
+ * converges, while a reversed or shuffled edge list needs length - 1 rounds.
+ *
+ * @param length Number of nodes in the chain.
+ * @param options Weight range, seed and thread count.
+ * @return A pointer to the generated graph, or NULL if it could not be allocated.
+ */
+Graph *generateChainGraph(int length, GeneratorOptions options)
+{
+	long long no_of_edges = length > 0 ? length - 1 : 0;
+	Graph *graph = allocateGraph(length, no_of_edges);
+	if (graph == NULL)
+		return NULL;
+
+	GeneratorTask task = {graph, options, 0, 0, 0, 0, NULL};
+	runGeneratorThreads(task, no_of_edges, generateChainEdges);
+
+	return graph;
+}
+
+/**
+ * @brief Introduces negative edge weights without creating negative weight cycles.
+ *
+ * Every node v gets a random potential p(v) in [0, max_potential] and every edge
+ * (u, v, w) is reweighted to w + p(u) - p(v). The potentials cancel along any cycle,
+ * so cycle weights are unchanged and a graph with non-negative weights stays free of
+ * negative cycles, while up to half of the edges become negative. Shortest paths are
+ * shifted by p(source) - p(target) and therefore keep the same structure.
+ *
+ * @param graph The graph to reweight in place.
+ * @param max_potential Largest potential, bounds how negative a weight can become.
+ * @param seed Seed of the potentials.
+ */
+void applyNegativeWeights(Graph *graph, int max_potential, unsigned long long seed)
+{
+	for (int i = 0; i < graph->no_of_edges; i++)
+	{
+		Edge &edge = graph->edge[i];
+		int source_potential = (int)(randomAt(seed, edge.source) % ((uint64_t)max_potential + 1));
+		int destination_potential = (int)(randomAt(seed, edge.destination) % ((uint64_t)max_potential + 1));
+		edge.weight += source_potential - destination_potential;
+	}
+}
@@ -0,0 +1,25 @@
+#ifndef GRAPH_GENERATOR_H
+#define GRAPH_GENERATOR_H
+
+#include "graph.h"
+
+// Parameters shared by all synthetic graph generators.
+struct GeneratorOptions
+{
+	// edge weights are drawn uniformly from [min_weight, max_weight]
+	int min_weight;
+	int max_weight;
+	// seed of the random number generator, the same seed always gives the same graph
+	unsigned long long seed;
+	// number of pthreads used to generate the edges
+	int num_threads;
+};
+
+GeneratorOptions defaultGeneratorOptions();
+
+Graph *generateRmatGraph(int scale, int edge_factor, GeneratorOptions options);
+Graph *generateGridGraph(int rows, int cols, GeneratorOptions options);
+Graph *generateChainGraph(int length, GeneratorOptions options);
+void applyNegativeWeights(Graph *graph, int max_potential, unsigned long long seed);
+
+#endif // GRAPH_GENERATOR_H
@@ -0,0 +1,236 @@
+#include "numa_topology.h"
+#include <fstream>		 // For reading sysfs
+#include <sstream>		 // For parsing cpu lists
+#include <string>		 // For string operations
+#include <pthread.h>	 // For thread affinity
+#include <sched.h>		 // For cpu sets
+#include <unistd.h>		 // For sysconf and syscall
+#include <sys/mman.h>	 // For mmap
+#include <sys/syscall.h> // For mbind
+#include <linux/mempolicy.h>
+
+using namespace std;
+
+/**
+ * @brief Parses a sysfs cpu list such as "0-3,8-11".
+ */
+static vector<int> parseCpuList(const string &list)
+{
+	vector<int> cpus;
+	stringstream ranges(list);
+	string range;
+
+	while (getline(ranges, range, ','))
+	{
+		if (range.empty())
+			continue;
+		size_t dash = range.find('-');
+		int first = stoi(range.substr(0, dash));
+		int last = dash == string::npos ? first : stoi(range.substr(dash + 1));
+		for (int cpu = first; cpu <= last; cpu++)
+			cpus.push_back(cpu);
+	}
+
+	return cpus;
+}
+
+/**
+ * @brief Reads the NUMA layout from /sys/devices/system/node.
+ *
+ * Machines without NUMA information (or with a single node) are reported as one node
+ * holding every online CPU, so callers do not need a special case.
+ */
+NumaTopology detectNumaTopology()
+{
+	NumaTopology topology;
+	topology.no_of_nodes = 0;
+
+	for (int node = 0;; node++)
+	{
+		ifstream cpulist("/sys/devices/system/node/node" + to_string(node) + "/cpulist");
+		if (!cpulist.is_open())
+			break;
+		string list;
+		getline(cpulist, list);
+		topology.cpus_of_node.push_back(parseCpuList(list));
+		topology.no_of_nodes++;
+	}
+
+	if (topology.no_of_nodes == 0)
+	{
+		long no_of_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		topology.no_of_nodes = 1;
+		topology.cpus_of_node.assign(1, vector<int>());
+		for (int cpu = 0; cpu < no_of_cpus; cpu++)
+			topology.cpus_of_node[0].push_back(cpu);
+	}
+
+	return topology;
+}
+
+/**
+ * @brief Spreads threads over the NUMA nodes in contiguous blocks.
+ *
+ * Thread tn goes to node tn * no_of_nodes / num_threads, so neighbouring threads (which
+ * process neighbouring edge partitions) share a node.
+ *
+ * @return The node of every thread.
+ */
+vector<int> assignThreadsToNodes(const NumaTopology &topology, int num_threads)
+{
+	vector<int> node_of_thread(num_threads);
+	for (int tn = 0; tn < num_threads; tn++)
+		node_of_thread[tn] = (int)((long long)tn * topology.no_of_nodes / num_threads);
+	return node_of_thread;
+}
+
+/**
+ * @brief Picks a distinct CPU for every thread within its node, wrapping around when a
+ * node has more threads than CPUs.
+ *
+ * @return The CPU of every thread.
+ */
+vector<int> assignThreadsToCpus(const NumaTopology &topology, const vector<int> &node_of_thread)
+{
+	vector<int> cpu_of_thread(node_of_thread.size());
+	vector<int> next_cpu(topology.no_of_nodes, 0);
+
+	for (size_t tn = 0; tn < node_of_thread.size(); tn++)
+	{
+		const vector<int> &cpus = topology.cpus_of_node[node_of_thread[tn]];
+		cpu_of_thread[tn] = cpus.empty() ? -1 : cpus[next_cpu[node_of_thread[tn]]++ % cpus.size()];
+	}
+
+	return cpu_of_thread;
+}
+
+/**
+ * @brief Pins the calling thread to one CPU.
+ *
+ * @return false if the CPU is invalid or the affinity could not be set.
+ */
+bool pinCurrentThread(int cpu)
+{
+	if (cpu < 0)
+		return false;
+
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+/**
+ * @brief Lets the calling thread run on every CPU of the machine again.
+ */
+bool unpinCurrentThread(const NumaTopology &topology)
+{
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for (const vector<int> &cpus : topology.cpus_of_node)
+	{
+		for (int cpu : cpus)
+			CPU_SET(cpu, &set);
+	}
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+/**
+ * @brief Saves the CPU affinity of the calling thread, to be put back with restoreAffinity.
+ */
+bool saveCurrentAffinity(cpu_set_t *affinity)
+{
+	return pthread_getaffinity_np(pthread_self(), sizeof(*affinity), affinity) == 0;
+}
+
+/**
+ * @brief Puts back an affinity saved with saveCurrentAffinity, from any thread.
+ */
+bool restoreAffinity(pthread_t thread, const cpu_set_t &affinity)
+{
+	return pthread_setaffinity_np(thread, sizeof(affinity), &affinity) == 0;
+}
+
+/**
+ * @brief Applies a memory policy to the whole pages of a range and migrates them.
+ */
+static bool applyMemoryPolicy(void *address, size_t bytes, const NumaTopology &topology, size_t page_bytes,
+							  int mode)
+{
+	if (topology.no_of_nodes < 2)
+		return true;
+
+	size_t page = page_bytes > 0 ? page_bytes : (size_t)sysconf(_SC_PAGESIZE);
+	uintptr_t begin = ((uintptr_t)address + page - 1) & ~(uintptr_t)(page - 1);
+	uintptr_t end = ((uintptr_t)address + bytes) & ~(uintptr_t)(page - 1);
+	if (end <= begin)
+		return true;
+
+	if (mode == MPOL_DEFAULT)
+		return syscall(SYS_mbind, begin, end - begin, MPOL_DEFAULT, NULL, 0, MPOL_MF_MOVE) == 0;
+
+	unsigned long node_mask[16] = {0};
+	for (int node = 0; node < topology.no_of_nodes && node < (int)(sizeof(node_mask) * 8); node++)
+		node_mask[node / (sizeof(unsigned long) * 8)] |= 1UL << (node % (sizeof(unsigned long) * 8));
+
+	return syscall(SYS_mbind, begin, end - begin, mode, node_mask, sizeof(node_mask) * 8, MPOL_MF_MOVE) == 0;
+}
+
+/**
+ * @brief Spreads the pages of a memory range round-robin over all NUMA nodes.
+ *
+ * Pages that were already touched are migrated. Only whole pages inside the range are
+ * affected. Does nothing on single node machines.
+ *
+ * @param page_bytes Page size of the mapping holding the range, 0 for the base page
+ * size. Memory backed by explicit huge pages has to pass its huge page size, mbind
+ * rejects ranges that are not aligned to it.
+ * @return false if mbind rejected the range, true otherwise (also when there was nothing
+ * to place).
+ */
+bool interleaveMemory(void *address, size_t bytes, const NumaTopology &topology, size_t page_bytes)
+{
+	return applyMemoryPolicy(address, bytes, topology, page_bytes, MPOL_INTERLEAVE);
+}
+
+/**
+ * @brief Undoes interleaveMemory: the range goes back to the default policy and its pages
+ * move to the node of the calling thread, as if it had touched them first.
+ *
+ * @param page_bytes As for interleaveMemory.
+ * @return false if mbind rejected the range.
+ */
+bool resetMemoryPolicy(void *address, size_t bytes, const NumaTopology &topology, size_t page_bytes)
+{
+	return applyMemoryPolicy(address, bytes, topology, page_bytes, MPOL_DEFAULT);
+}
+
+/**
+ * @brief Allocates memory whose pages land on the NUMA node of the calling thread.
+ *
+ * The pages are mapped fresh and touched by the caller, so with the default first-touch
+ * policy they are placed on the node the (pinned) calling thread runs on.
+ *
+ * @return The memory, released with releaseNodeMemory, or NULL.
+ */
+void *allocateOnCurrentNode(size_t bytes)
+{
+	if (bytes == 0)
+		return NULL;
+
+	void *memory = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (memory == MAP_FAILED)
+		return NULL;
+
+	size_t page = (size_t)sysconf(_SC_PAGESIZE);
+	for (size_t offset = 0; offset < bytes; offset += page)
+		((volatile char *)memory)[offset] = 0;
+
+	return memory;
+}
+
+void releaseNodeMemory(void *address, size_t bytes)
+{
+	if (address != NULL)
+		munmap(address, bytes);
+}
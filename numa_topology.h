@@ -0,0 +1,28 @@
+#ifndef NUMA_TOPOLOGY_H
+#define NUMA_TOPOLOGY_H
+
+#include <pthread.h>
+#include <sched.h>
+#include <cstddef>
+#include <vector>
+
+// NUMA nodes of the machine and the CPUs that belong to each of them.
+struct NumaTopology
+{
+	int no_of_nodes;
+	std::vector<std::vector<int>> cpus_of_node;
+};
+
+NumaTopology detectNumaTopology();
+std::vector<int> assignThreadsToNodes(const NumaTopology &topology, int num_threads);
+std::vector<int> assignThreadsToCpus(const NumaTopology &topology, const std::vector<int> &node_of_thread);
+bool pinCurrentThread(int cpu);
+bool unpinCurrentThread(const NumaTopology &topology);
+bool saveCurrentAffinity(cpu_set_t *affinity);
+bool restoreAffinity(pthread_t thread, const cpu_set_t &affinity);
+bool interleaveMemory(void *address, size_t bytes, const NumaTopology &topology, size_t page_bytes = 0);
+bool resetMemoryPolicy(void *address, size_t bytes, const NumaTopology &topology, size_t page_bytes = 0);
+void *allocateOnCurrentNode(size_t bytes);
+void releaseNodeMemory(void *address, size_t bytes);
+
+#endif // NUMA_TOPOLOGY_H
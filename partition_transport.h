@@ -0,0 +1,52 @@
+#ifndef PARTITION_TRANSPORT_H
+#define PARTITION_TRANSPORT_H
+
+#include <vector>
+
+// new distance of a boundary vertex, sent to the partition that owns the vertex
+struct BoundaryUpdate
+{
+	int node;
+	long distance;
+};
+
+// Message layer between the workers of a partitioned solve.
+//
+// Every round each worker sends the boundary updates it produced with send(), then calls
+// exchange() to receive the updates addressed to it, then vote() to agree on whether any
+// partition still changed. All workers make the same sequence of calls, so both
+// exchange() and vote() act as a global step. The relaxation code only sees this
+// interface: the shared-memory transport serves processes on one machine, a network
+// transport can serve workers on several machines.
+class PartitionTransport
+{
+public:
+	virtual ~PartitionTransport() {}
+
+	// binds the calling worker to its partition, called once in every worker before solving
+	virtual void attach(int rank) = 0;
+	virtual int rank() const = 0;
+	virtual int size() const = 0;
+
+	/**
+	 * @brief Queues updates for partition to, delivered by the next exchange().
+	 *
+	 * @return false if they do not fit into the mailbox.
+	 */
+	virtual bool send(int to, const BoundaryUpdate *updates, int count) = 0;
+
+	/**
+	 * @brief Waits until every partition has sent this round's updates and returns the
+	 * ones addressed to this partition.
+	 */
+	virtual void exchange(std::vector<BoundaryUpdate> &received) = 0;
+
+	/**
+	 * @brief Global convergence vote.
+	 *
+	 * @return true if any partition voted changed.
+	 */
+	virtual bool vote(bool changed) = 0;
+};
+
+#endif // PARTITION_TRANSPORT_H
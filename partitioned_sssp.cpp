@@ -0,0 +1,302 @@
+#include "partitioned_sssp.h"
+#include "shared_memory_transport.h"
+#include "sssp_c_api.h"
+#include <algorithm>  // For sort, unique and min
+#include <csignal>	  // For SIGKILL
+#include <cstring>	  // For memcpy
+#include <unistd.h>	  // For fork, _exit and usleep
+#include <sys/mman.h> // For shared result arrays
+#include <sys/wait.h> // For waitpid
+
+using namespace std;
+
+static int ownerOf(const PartitionPlan &plan, int node)
+{
+	return node / plan.block_size;
+}
+
+/**
+ * @brief Splits the vertices into no_of_partitions contiguous blocks and sizes the mailboxes.
+ *
+ * Each partition owns a block of vertices and the edges leaving them. An edge whose
+ * destination lies in another block is a boundary edge, its relaxations are sent to the
+ * destination's owner.
+ */
+PartitionPlan planPartitions(const Graph *graph, int no_of_partitions)
+{
+	PartitionPlan plan;
+	plan.no_of_partitions = no_of_partitions;
+	plan.no_of_nodes = graph->no_of_nodes;
+	for (int i = 0; i < graph->no_of_edges; i++)
+		plan.no_of_nodes = max(plan.no_of_nodes, max(graph->edge[i].source, graph->edge[i].destination) + 1);
+	plan.block_size = max(1, (plan.no_of_nodes + no_of_partitions - 1) / no_of_partitions);
+
+	// distinct (sending partition, remote destination) pairs
+	vector<long long> boundary_pairs;
+	for (int i = 0; i < graph->no_of_edges; i++)
+	{
+		int from = ownerOf(plan, graph->edge[i].source), to = ownerOf(plan, graph->edge[i].destination);
+		if (from != to)
+			boundary_pairs.push_back((long long)from * plan.no_of_nodes + graph->edge[i].destination);
+	}
+	sort(boundary_pairs.begin(), boundary_pairs.end());
+	boundary_pairs.erase(unique(boundary_pairs.begin(), boundary_pairs.end()), boundary_pairs.end());
+
+	plan.mailbox_capacity.assign((size_t)no_of_partitions * no_of_partitions, 0);
+	for (long long pair : boundary_pairs)
+	{
+		int from = (int)(pair / plan.no_of_nodes), to = ownerOf(plan, (int)(pair % plan.no_of_nodes));
+		plan.mailbox_capacity[(size_t)from * no_of_partitions + to]++;
+	}
+
+	return plan;
+}
+
+/**
+ * @brief Solves one partition, exchanging boundary distances with the others every round.
+ *
+ * Every round relaxes the partition's local edges in place and its boundary edges into
+ * the best distance sent so far for each remote vertex; only improvements are sent. The
+ * updates received from other partitions are applied at the end of the round and the
+ * partitions vote on whether anything changed. A round never does less than a
+ * synchronous Bellman-Ford round, so a change in round no_of_nodes means a negative
+ * cycle is reachable. This function only talks to the transport, so it runs unchanged
+ * over any PartitionTransport.
+ *
+ * @param graph The whole graph, each worker keeps only its own edges.
+ * @param plan The partitioning shared by all workers.
+ * @param source_node_id The source node.
+ * @param transport Transport already attached to this worker's rank.
+ * @param distances Array of plan.no_of_nodes distances, this worker fills its own block.
+ * @param stats Filled with this worker's counters.
+ * @return SSSP_OK, SSSP_NEGATIVE_CYCLE, or SSSP_ERROR_WORKER_FAILED if a mailbox overflowed.
+ */
+int runPartitionWorker(const Graph *graph, const PartitionPlan &plan, int source_node_id,
+					   PartitionTransport *transport, long *distances, PartitionStats *stats)
+{
+	int rank = transport->rank();
+	int begin = min(plan.no_of_nodes, rank * plan.block_size);
+	int end = min(plan.no_of_nodes, (rank + 1) * plan.block_size);
+
+	// remote destinations sorted by id, so the vertices of each owner are contiguous slots
+	vector<int> boundary_nodes;
+	for (int i = 0; i < graph->no_of_edges; i++)
+	{
+		const Edge &edge = graph->edge[i];
+		if (ownerOf(plan, edge.source) == rank && ownerOf(plan, edge.destination) != rank)
+			boundary_nodes.push_back(edge.destination);
+	}
+	sort(boundary_nodes.begin(), boundary_nodes.end());
+	boundary_nodes.erase(unique(boundary_nodes.begin(), boundary_nodes.end()), boundary_nodes.end());
+
+	// local edges use block-relative ids, boundary edges point at their boundary slot
+	vector<Edge> local_edges, boundary_edges;
+	for (int i = 0; i < graph->no_of_edges; i++)
+	{
+		const Edge &edge = graph->edge[i];
+		if (ownerOf(plan, edge.source) != rank)
+			continue;
+		if (ownerOf(plan, edge.destination) == rank)
+			local_edges.push_back({edge.source - begin, edge.destination - begin, edge.weight});
+		else
+		{
+			int slot = (int)(lower_bound(boundary_nodes.begin(), boundary_nodes.end(), edge.destination) -
+							 boundary_nodes.begin());
+			boundary_edges.push_back({edge.source - begin, slot, edge.weight});
+		}
+	}
+
+	vector<long> node_distances(end - begin, SSSP_INFINITY);
+	if (source_node_id >= begin && source_node_id < end)
+		node_distances[source_node_id - begin] = 0;
+
+	vector<long> boundary_best(boundary_nodes.size(), SSSP_INFINITY);
+	vector<int> dirty_slots;
+	vector<char> dirty(boundary_nodes.size(), 0);
+	vector<BoundaryUpdate> outgoing, received;
+
+	*stats = PartitionStats();
+	stats->local_edges = local_edges.size();
+	stats->boundary_edges = boundary_edges.size();
+
+	bool changed = true, overflow = false;
+	// no_of_nodes - 1 rounds reach every shortest path, one more detects negative cycles
+	while (stats->rounds < plan.no_of_nodes)
+	{
+		stats->rounds++;
+		bool improved = false;
+
+		for (const Edge &edge : local_edges)
+		{
+			long source_distance = node_distances[edge.source];
+			if (source_distance < SSSP_INFINITY && source_distance + edge.weight < node_distances[edge.destination])
+			{
+				node_distances[edge.destination] = source_distance + edge.weight;
+				improved = true;
+			}
+		}
+
+		for (const Edge &edge : boundary_edges)
+		{
+			long source_distance = node_distances[edge.source];
+			if (source_distance < SSSP_INFINITY && source_distance + edge.weight < boundary_best[edge.destination])
+			{
+				boundary_best[edge.destination] = source_distance + edge.weight;
+				if (!dirty[edge.destination])
+				{
+					dirty[edge.destination] = 1;
+					dirty_slots.push_back(edge.destination);
+				}
+			}
+		}
+
+		// one message per owner, in slot order
+		sort(dirty_slots.begin(), dirty_slots.end());
+		for (size_t i = 0; i < dirty_slots.size();)
+		{
+			int owner = ownerOf(plan, boundary_nodes[dirty_slots[i]]);
+			outgoing.clear();
+			for (; i < dirty_slots.size() && ownerOf(plan, boundary_nodes[dirty_slots[i]]) == owner; i++)
+			{
+				outgoing.push_back({boundary_nodes[dirty_slots[i]], boundary_best[dirty_slots[i]]});
+				dirty[dirty_slots[i]] = 0;
+			}
+			if (!transport->send(owner, outgoing.data(), (int)outgoing.size()))
+				overflow = true;
+			stats->boundary_updates_sent += outgoing.size();
+		}
+		dirty_slots.clear();
+
+		transport->exchange(received);
+		for (const BoundaryUpdate &update : received)
+		{
+			if (update.distance < node_distances[update.node - begin])
+			{
+				node_distances[update.node - begin] = update.distance;
+				improved = true;
+			}
+		}
+
+		changed = transport->vote(improved);
+		if (!changed)
+			break;
+	}
+
+	memcpy(distances + begin, node_distances.data(), node_distances.size() * sizeof(long));
+
+	if (overflow)
+		return SSSP_ERROR_WORKER_FAILED;
+	return changed ? SSSP_NEGATIVE_CYCLE : SSSP_OK;
+}
+
+/**
+ * @brief Solves on no_of_partitions worker processes that exchange boundary distances
+ * through shared memory.
+ *
+ * The workers are forked from the calling process and inherit the graph copy-on-write.
+ * If any worker dies the others are killed, since they would wait for it forever. Only
+ * the workers' own pids are waited for, so other children of the application are left
+ * alone.
+ *
+ * @param graph The graph to solve on.
+ * @param source_node_id The source node.
+ * @param no_of_partitions Number of worker processes.
+ * @param distances Resized to the node count and filled with the distances.
+ * @param stats Resized to no_of_partitions and filled with the per-worker counters.
+ * @return SSSP_OK, SSSP_NEGATIVE_CYCLE or a negative error code.
+ */
+int solvePartitioned(const Graph *graph, int source_node_id, int no_of_partitions, vector<long> *distances,
+					 vector<PartitionStats> *stats)
+{
+	if (graph == NULL)
+		return SSSP_ERROR_NO_GRAPH;
+	if (no_of_partitions < 1 || no_of_partitions > SHARED_MEMORY_MAX_PARTITIONS)
+		return SSSP_ERROR_INVALID_ARGUMENT;
+
+	PartitionPlan plan = planPartitions(graph, no_of_partitions);
+	if (source_node_id < 0 || source_node_id >= plan.no_of_nodes)
+		return SSSP_ERROR_INVALID_SOURCE;
+
+	SharedMemoryTransport transport(no_of_partitions, plan.mailbox_capacity);
+	if (!transport.valid())
+		return SSSP_ERROR_WORKER_FAILED;
+
+	// results written by the workers
+	size_t result_bytes = (size_t)plan.no_of_nodes * sizeof(long) +
+						  (size_t)no_of_partitions * (sizeof(PartitionStats) + sizeof(int));
+	char *results = (char *)mmap(NULL, result_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (results == MAP_FAILED)
+		return SSSP_ERROR_WORKER_FAILED;
+	long *shared_distances = (long *)results;
+	PartitionStats *shared_stats = (PartitionStats *)(shared_distances + plan.no_of_nodes);
+	int *shared_status = (int *)(shared_stats + no_of_partitions);
+
+	vector<pid_t> workers;
+	for (int p = 0; p < no_of_partitions; p++)
+	{
+		pid_t pid = fork();
+		if (pid == 0)
+		{
+			transport.attach(p);
+			shared_status[p] = runPartitionWorker(graph, plan, source_node_id, &transport, shared_distances,
+												  &shared_stats[p]);
+			_exit(0);
+		}
+		if (pid < 0)
+		{
+			for (pid_t worker : workers)
+				kill(worker, SIGKILL);
+			for (pid_t worker : workers)
+				waitpid(worker, NULL, 0);
+			munmap(results, result_bytes);
+			return SSSP_ERROR_WORKER_FAILED;
+		}
+		workers.push_back(pid);
+	}
+
+	// poll the workers rather than blocking on one of them, a worker that waits for a dead
+	// one would never exit
+	int status = SSSP_OK;
+	vector<pid_t> running = workers;
+	while (!running.empty())
+	{
+		bool reaped = false;
+		for (size_t i = 0; i < running.size(); i++)
+		{
+			int exit_status;
+			pid_t pid = waitpid(running[i], &exit_status, WNOHANG);
+			if (pid == 0)
+				continue;
+
+			reaped = true;
+			running[i--] = running.back();
+			running.pop_back();
+			bool failed = pid > 0 && !(WIFEXITED(exit_status) && WEXITSTATUS(exit_status) == 0);
+			if (failed && status != SSSP_ERROR_WORKER_FAILED)
+			{
+				status = SSSP_ERROR_WORKER_FAILED;
+				for (pid_t worker : running)
+					kill(worker, SIGKILL);
+			}
+		}
+		if (!reaped)
+			usleep(100);
+	}
+
+	if (status == SSSP_OK)
+	{
+		// all workers agree on the vote, only an overflow differs per worker
+		for (int p = 0; p < no_of_partitions; p++)
+		{
+			if (shared_status[p] < 0)
+				status = shared_status[p];
+			else if (status == SSSP_OK)
+				status = shared_status[p];
+		}
+		distances->assign(shared_distances, shared_distances + plan.no_of_nodes);
+		stats->assign(shared_stats, shared_stats + no_of_partitions);
+	}
+
+	munmap(results, result_bytes);
+	return status;
+}
@@ -0,0 +1,36 @@
+#ifndef PARTITIONED_SSSP_H
+#define PARTITIONED_SSSP_H
+
+#include <vector>
+#include "graph.h"
+#include "partition_transport.h"
+
+// how the vertices and edges of a graph are split into partitions
+struct PartitionPlan
+{
+	int no_of_partitions;
+	// node count widened to cover every id used by an edge
+	int no_of_nodes;
+	// partition p owns the vertices [p * block_size, (p + 1) * block_size)
+	int block_size;
+	// updates partition from can send to partition to in one round: the distinct
+	// vertices owned by to that are destinations of from's edges
+	std::vector<long long> mailbox_capacity;
+};
+
+// what one worker did, collected by the parent
+struct PartitionStats
+{
+	int rounds;
+	long long local_edges;
+	long long boundary_edges;
+	long long boundary_updates_sent;
+};
+
+PartitionPlan planPartitions(const Graph *graph, int no_of_partitions);
+int runPartitionWorker(const Graph *graph, const PartitionPlan &plan, int source_node_id,
+					   PartitionTransport *transport, long *distances, PartitionStats *stats);
+int solvePartitioned(const Graph *graph, int source_node_id, int no_of_partitions, std::vector<long> *distances,
+					 std::vector<PartitionStats> *stats);
+
+#endif // PARTITIONED_SSSP_H
@@ -0,0 +1,220 @@
+#include "perf_counters.h"
+#include <iostream>	   // For input/output stream
+#include <chrono>	   // For high resolution timing
+#include <cstdio>	   // For writing the trace file
+#include <cstdlib>	   // For getenv
+#include <cstring>	   // For memset
+#include <unistd.h>	   // For read, close and syscall
+#include <sys/ioctl.h> // For enabling and disabling the counters
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+using namespace std;
+
+// column names of the hardware events in the trace file, indexed by PerfEvent
+static const char *PERF_EVENT_NAMES[PERF_EVENT_COUNT] = {"cycles", "instructions", "llc_misses", "branch_misses", "dtlb_misses"};
+
+/**
+ * @brief Opens one hardware counter for the calling thread as a member of a group.
+ *
+ * All events of a group are scheduled onto the PMU together, so when the kernel has to
+ * multiplex them with other users every event misses the same share of a round, and the
+ * time_enabled / time_running pair read with the group scales them back.
+ *
+ * Only the calling thread is counted. The traced kernels are single threaded, and an
+ * inherited counter could neither be read as a group nor include live child threads.
+ *
+ * @param group_fd The group leader, or -1 to open a new group.
+ * @return The perf file descriptor, or -1 if the event is not available (e.g. inside a
+ * container or with perf_event_paranoid set too high).
+ */
+static int openPerfEvent(unsigned int type, unsigned long long config, int group_fd)
+{
+	struct perf_event_attr attr;
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = type;
+	attr.config = config;
+	// members follow the leader, which is enabled once the whole group is open
+	attr.disabled = group_fd < 0;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+	return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+/**
+ * @brief Reads every event of the group at once.
+ *
+ * Events outside the group are set to -1, and so are all of them if the read fails.
+ */
+static void readPerfGroup(RoundTrace *trace, long long events[PERF_EVENT_COUNT], long long *enabled,
+						  long long *running)
+{
+	// nr, time_enabled, time_running, then one value per member in the order they were opened
+	unsigned long long buffer[3 + PERF_EVENT_COUNT];
+	ssize_t bytes = trace->group_fd < 0 ? -1 : read(trace->group_fd, buffer, sizeof(buffer));
+	bool ok = bytes >= (ssize_t)(3 * sizeof(buffer[0]));
+
+	*enabled = ok ? (long long)buffer[1] : 0;
+	*running = ok ? (long long)buffer[2] : 0;
+	unsigned long long member = 0;
+	for (int e = 0; e < PERF_EVENT_COUNT; e++)
+	{
+		if (trace->fds[e] < 0)
+			events[e] = -1;
+		else if (ok && member < buffer[0])
+			events[e] = (long long)buffer[3 + member++];
+		else
+			events[e] = -1;
+	}
+}
+
+static long long nowMicroseconds()
+{
+	return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Prepares a per-round trace for one run of a relaxation loop.
+ *
+ * Tracing is enabled only when the BF_ROUND_TRACE environment variable names an output
+ * file, otherwise no counters are opened and roundTraceBegin/roundTraceEnd reduce to a
+ * single branch. The label is written into every trace line so several runs (e.g. the
+ * SIMD kernels with and without tiling) can share one file.
+ *
+ * @param trace The trace to initialise.
+ * @param label Name of the engine being traced.
+ */
+void roundTraceInit(RoundTrace *trace, string label)
+{
+	const char *output_path = getenv("BF_ROUND_TRACE");
+
+	trace->enabled = output_path != NULL && output_path[0] != '\0';
+	trace->label = label;
+	trace->current_round = -1;
+	trace->rounds.clear();
+	trace->group_fd = -1;
+	for (int e = 0; e < PERF_EVENT_COUNT; e++)
+		trace->fds[e] = -1;
+
+	if (!trace->enabled)
+		return;
+
+	trace->output_path = output_path;
+	const unsigned int types[PERF_EVENT_COUNT] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+												  PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE};
+	// generic cache events are encoded as cache id | operation << 8 | result << 16
+	const unsigned long long configs[PERF_EVENT_COUNT] = {
+		PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES,
+		PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)};
+
+	// the first event that opens leads the group
+	trace->group_fd = -1;
+	for (int e = 0; e < PERF_EVENT_COUNT; e++)
+	{
+		trace->fds[e] = openPerfEvent(types[e], configs[e], trace->group_fd);
+		if (trace->fds[e] < 0)
+			cout << "Hardware counter " << PERF_EVENT_NAMES[e] << " is not available, it is reported as -1\n";
+		else if (trace->group_fd < 0)
+			trace->group_fd = trace->fds[e];
+	}
+
+	if (trace->group_fd >= 0)
+	{
+		ioctl(trace->group_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+		ioctl(trace->group_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	}
+}
+
+/**
+ * @brief Records the counter values at the start of a round.
+ */
+void roundTraceBeginSlow(RoundTrace *trace, int round)
+{
+	trace->current_round = round;
+	readPerfGroup(trace, trace->round_start_events, &trace->round_start_enabled, &trace->round_start_running);
+	trace->round_start_time = nowMicroseconds();
+}
+
+/**
+ * @brief Closes the current round and stores its work and counter deltas.
+ *
+ * @param edges_scanned Number of edges looked at in the round.
+ * @param relaxations Number of successful distance updates in the round.
+ * @param active_vertices Number of distinct vertices whose distance improved in the round.
+ */
+void roundTraceEndSlow(RoundTrace *trace, long long edges_scanned, long long relaxations, long long active_vertices)
+{
+	RoundStats stats;
+	stats.microseconds = nowMicroseconds() - trace->round_start_time;
+	long long events[PERF_EVENT_COUNT], enabled, running;
+	readPerfGroup(trace, events, &enabled, &running);
+
+	// while multiplexed the group only counted for part of the round, extrapolate to all of it
+	long long enabled_delta = enabled - trace->round_start_enabled;
+	long long running_delta = running - trace->round_start_running;
+	for (int e = 0; e < PERF_EVENT_COUNT; e++)
+	{
+		if (events[e] < 0 || trace->round_start_events[e] < 0 || running_delta <= 0)
+			stats.events[e] = -1;
+		else
+			stats.events[e] = (long long)((double)(events[e] - trace->round_start_events[e]) * enabled_delta / running_delta);
+	}
+	stats.round = trace->current_round;
+	stats.edges_scanned = edges_scanned;
+	stats.relaxations = relaxations;
+	stats.active_vertices = active_vertices;
+
+	trace->rounds.push_back(stats);
+}
+
+/**
+ * @brief Appends the collected rounds to the trace file as CSV and closes the counters.
+ *
+ * The header line is only written when the file is empty, so consecutive runs append
+ * to the same file and can be told apart by the label column.
+ */
+void roundTraceFinish(RoundTrace *trace)
+{
+	if (!trace->enabled)
+		return;
+
+	for (int e = 0; e < PERF_EVENT_COUNT; e++)
+	{
+		if (trace->fds[e] >= 0)
+			close(trace->fds[e]);
+		trace->fds[e] = -1;
+	}
+	trace->group_fd = -1;
+
+	FILE *fp = fopen(trace->output_path.c_str(), "a");
+	if (fp == NULL)
+	{
+		cout << "Could not open round trace file: " << trace->output_path << endl;
+		return;
+	}
+
+	fseek(fp, 0, SEEK_END);
+	if (ftell(fp) == 0)
+	{
+		fprintf(fp, "label,round,edges_scanned,relaxations,active_vertices,microseconds");
+		for (int e = 0; e < PERF_EVENT_COUNT; e++)
+			fprintf(fp, ",%s", PERF_EVENT_NAMES[e]);
+		fprintf(fp, "\n");
+	}
+
+	for (const RoundStats &stats : trace->rounds)
+	{
+		fprintf(fp, "%s,%d,%lld,%lld,%lld,%lld", trace->label.c_str(), stats.round, stats.edges_scanned,
+				stats.relaxations, stats.active_vertices, stats.microseconds);
+		for (int e = 0; e < PERF_EVENT_COUNT; e++)
+			fprintf(fp, ",%lld", stats.events[e]);
+		fprintf(fp, "\n");
+	}
+
+	fclose(fp);
+	cout << "Round trace of " << trace->label << " (" << trace->rounds.size() << " rounds) written to "
+		 << trace->output_path << endl;
+}
@@ -0,0 +1,65 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <string>
+#include <vector>
+
+// hardware events sampled around every relaxation round
+enum PerfEvent
+{
+	PERF_CYCLES,
+	PERF_INSTRUCTIONS,
+	PERF_LLC_MISSES,
+	PERF_BRANCH_MISSES,
+	PERF_DTLB_MISSES,
+	PERF_EVENT_COUNT
+};
+
+// work done and hardware events counted in one round of the relaxation loop
+struct RoundStats
+{
+	int round;
+	long long edges_scanned;
+	long long relaxations;
+	long long active_vertices;
+	long long microseconds;
+	long long events[PERF_EVENT_COUNT];
+};
+
+// per-round trace of one run, enabled at run time with the BF_ROUND_TRACE environment variable
+struct RoundTrace
+{
+	bool enabled;
+	std::string label;
+	std::string output_path;
+	// the events are opened as one group led by group_fd, -1 where an event is not available
+	int group_fd;
+	int fds[PERF_EVENT_COUNT];
+	long long round_start_events[PERF_EVENT_COUNT];
+	// time the group was enabled and actually counting, to scale for multiplexing
+	long long round_start_enabled;
+	long long round_start_running;
+	long long round_start_time;
+	int current_round;
+	std::vector<RoundStats> rounds;
+};
+
+void roundTraceInit(RoundTrace *trace, std::string label);
+void roundTraceBeginSlow(RoundTrace *trace, int round);
+void roundTraceEndSlow(RoundTrace *trace, long long edges_scanned, long long relaxations, long long active_vertices);
+void roundTraceFinish(RoundTrace *trace);
+
+// The hot loop only pays for a predictable branch when tracing is off.
+inline void roundTraceBegin(RoundTrace *trace, int round)
+{
+	if (trace->enabled)
+		roundTraceBeginSlow(trace, round);
+}
+
+inline void roundTraceEnd(RoundTrace *trace, long long edges_scanned, long long relaxations, long long active_vertices)
+{
+	if (trace->enabled)
+		roundTraceEndSlow(trace, edges_scanned, relaxations, active_vertices);
+}
+
+#endif // PERF_COUNTERS_H
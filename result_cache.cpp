@@ -0,0 +1,258 @@
+#include "result_cache.h"
+#include "sssp_c_api.h" // For SSSP_INFINITY
+#include <algorithm>	// For min and max
+
+using namespace std;
+
+// number of distances per compressed block
+static const int RESULT_CACHE_BLOCK = 128;
+
+// fixed cost of an entry besides its blocks, covers the list node and the index slot
+static const size_t ENTRY_OVERHEAD_BYTES = 96;
+
+static int bitWidth(uint64_t value)
+{
+	return value == 0 ? 0 : 64 - __builtin_clzll(value);
+}
+
+static void writeBits(vector<uint64_t> &packed, uint64_t bit_position, int bits, uint64_t value)
+{
+	size_t word = bit_position >> 6;
+	int offset = bit_position & 63;
+	packed[word] |= value << offset;
+	if (offset + bits > 64)
+		packed[word + 1] |= value >> (64 - offset);
+}
+
+static uint64_t readBits(const vector<uint64_t> &packed, uint64_t bit_position, int bits)
+{
+	size_t word = bit_position >> 6;
+	int offset = bit_position & 63;
+	uint64_t value = packed[word] >> offset;
+	if (offset + bits > 64)
+		value |= packed[word + 1] << (64 - offset);
+	return bits == 64 ? value : value & ((1ULL << bits) - 1);
+}
+
+size_t ResultCache::Entry::bytes() const
+{
+	return ENTRY_OVERHEAD_BYTES + blocks.size() * sizeof(BlockHeader) + packed.size() * sizeof(uint64_t);
+}
+
+/**
+ * @brief Creates an empty cache that never holds more than memory_budget_bytes of entries.
+ */
+ResultCache::ResultCache(size_t memory_budget_bytes) : memory_budget_bytes_(memory_budget_bytes)
+{
+	pthread_mutex_init(&mutex_, NULL);
+	stats_ = CacheStats();
+}
+
+ResultCache::~ResultCache()
+{
+	pthread_mutex_destroy(&mutex_);
+}
+
+/**
+ * @brief Decodes the distance of one node from a compressed entry.
+ */
+long ResultCache::decode(const Entry &entry, int node) const
+{
+	const BlockHeader &block = entry.blocks[node / RESULT_CACHE_BLOCK];
+	if (block.bits == 0)
+		return SSSP_INFINITY;
+
+	uint64_t stored = readBits(entry.packed, block.bit_offset + (uint64_t)(node % RESULT_CACHE_BLOCK) * block.bits, block.bits);
+	return stored == 0 ? SSSP_INFINITY : (long)(block.base + (int64_t)(stored - 1));
+}
+
+/**
+ * @brief Finds the entry of a source and moves it to the front of the LRU list.
+ *
+ * An entry computed for another graph version is removed. Misses are counted here, hits
+ * by the caller once it knows the entry answers the query. Must be called with the mutex held.
+ */
+bool ResultCache::findCurrent(int source, unsigned long long graph_version, list<Entry>::iterator *found)
+{
+	auto it = index_.find(source);
+	if (it == index_.end())
+	{
+		stats_.misses++;
+		return false;
+	}
+
+	if (it->second->graph_version != graph_version)
+	{
+		erase(it->second);
+		stats_.invalidations++;
+		stats_.misses++;
+		return false;
+	}
+
+	lru_.splice(lru_.begin(), lru_, it->second);
+	*found = lru_.begin();
+	return true;
+}
+
+void ResultCache::erase(list<Entry>::iterator entry)
+{
+	stats_.bytes_used -= entry->bytes();
+	stats_.raw_bytes -= (long long)entry->count * sizeof(long);
+	stats_.entries--;
+	index_.erase(entry->source);
+	lru_.erase(entry);
+}
+
+/**
+ * @brief Looks up the distance from source to target.
+ *
+ * Only the block that holds the target is decoded, so a hit costs a hash lookup and a
+ * few bit operations.
+ *
+ * @return true on a hit, with the distance (SSSP_INFINITY if unreachable) in *distance.
+ */
+bool ResultCache::lookupDistance(int source, int target, unsigned long long graph_version, long *distance)
+{
+	pthread_mutex_lock(&mutex_);
+	list<Entry>::iterator entry;
+	bool hit = false;
+	if (findCurrent(source, graph_version, &entry))
+	{
+		// a target outside the cached vector cannot be answered from it
+		hit = target >= 0 && target < entry->count;
+		if (hit)
+		{
+			*distance = decode(*entry, target);
+			stats_.hits++;
+		}
+		else
+			stats_.misses++;
+	}
+	pthread_mutex_unlock(&mutex_);
+	return hit;
+}
+
+/**
+ * @brief Looks up and decodes the whole distance vector of a source.
+ *
+ * @return true on a hit.
+ */
+bool ResultCache::lookup(int source, unsigned long long graph_version, vector<long> &distances)
+{
+	pthread_mutex_lock(&mutex_);
+	list<Entry>::iterator entry;
+	bool hit = findCurrent(source, graph_version, &entry);
+	if (hit)
+	{
+		stats_.hits++;
+		distances.resize(entry->count);
+		for (int node = 0; node < entry->count; node++)
+			distances[node] = decode(*entry, node);
+	}
+	pthread_mutex_unlock(&mutex_);
+	return hit;
+}
+
+/**
+ * @brief Compresses and stores the distance vector of a source, evicting the least
+ * recently used entries until the memory budget is met.
+ *
+ * @param distances Distance of node i at distances[i * stride], which lets a lane of
+ * an interleaved batch result be cached without copying it first.
+ * @param count Number of nodes.
+ * @param stride Distance between consecutive nodes in the array.
+ */
+void ResultCache::insert(int source, unsigned long long graph_version, const long *distances, int count, int stride)
+{
+	Entry entry;
+	entry.source = source;
+	entry.graph_version = graph_version;
+	entry.count = count;
+
+	int no_of_blocks = (count + RESULT_CACHE_BLOCK - 1) / RESULT_CACHE_BLOCK;
+	entry.blocks.resize(no_of_blocks);
+
+	uint64_t total_bits = 0;
+	for (int b = 0; b < no_of_blocks; b++)
+	{
+		int begin = b * RESULT_CACHE_BLOCK, end = min(count, begin + RESULT_CACHE_BLOCK);
+		int64_t low = INT64_MAX, high = INT64_MIN;
+		for (int node = begin; node < end; node++)
+		{
+			long distance = distances[(size_t)node * stride];
+			if (distance < SSSP_INFINITY)
+			{
+				low = min(low, (int64_t)distance);
+				high = max(high, (int64_t)distance);
+			}
+		}
+
+		BlockHeader &block = entry.blocks[b];
+		block.bit_offset = total_bits;
+		block.base = low == INT64_MAX ? 0 : low;
+		// stored values are distance - base + 1, leaving 0 for unreachable nodes
+		block.bits = low == INT64_MAX ? 0 : max(1, bitWidth((uint64_t)(high - low) + 1));
+		total_bits += (uint64_t)block.bits * RESULT_CACHE_BLOCK;
+	}
+
+	entry.packed.assign(total_bits / 64 + 2, 0);
+	for (int b = 0; b < no_of_blocks; b++)
+	{
+		const BlockHeader &block = entry.blocks[b];
+		if (block.bits == 0)
+			continue;
+		int begin = b * RESULT_CACHE_BLOCK, end = min(count, begin + RESULT_CACHE_BLOCK);
+		for (int node = begin; node < end; node++)
+		{
+			long distance = distances[(size_t)node * stride];
+			uint64_t stored = distance < SSSP_INFINITY ? (uint64_t)(distance - block.base) + 1 : 0;
+			writeBits(entry.packed, block.bit_offset + (uint64_t)(node - begin) * block.bits, block.bits, stored);
+		}
+	}
+
+	pthread_mutex_lock(&mutex_);
+
+	auto it = index_.find(source);
+	if (it != index_.end())
+		erase(it->second);
+
+	if (entry.bytes() <= memory_budget_bytes_)
+	{
+		while (!lru_.empty() && (size_t)stats_.bytes_used + entry.bytes() > memory_budget_bytes_)
+		{
+			erase(prev(lru_.end()));
+			stats_.evictions++;
+		}
+
+		stats_.bytes_used += entry.bytes();
+		stats_.raw_bytes += (long long)count * sizeof(long);
+		stats_.entries++;
+		lru_.push_front(std::move(entry));
+		index_[source] = lru_.begin();
+	}
+
+	pthread_mutex_unlock(&mutex_);
+}
+
+/**
+ * @brief Drops every entry, e.g. after the graph was replaced.
+ */
+void ResultCache::clear()
+{
+	pthread_mutex_lock(&mutex_);
+	stats_.invalidations += lru_.size();
+	lru_.clear();
+	index_.clear();
+	stats_.entries = 0;
+	stats_.bytes_used = 0;
+	stats_.raw_bytes = 0;
+	pthread_mutex_unlock(&mutex_);
+}
+
+CacheStats ResultCache::stats()
+{
+	pthread_mutex_lock(&mutex_);
+	CacheStats current = stats_;
+	pthread_mutex_unlock(&mutex_);
+	return current;
+}
@@ -0,0 +1,75 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <pthread.h>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+struct CacheStats
+{
+	long long hits;
+	long long misses;
+	long long evictions;
+	long long invalidations;
+	long long entries;
+	// compressed size of all entries and the size they would have uncompressed
+	long long bytes_used;
+	long long raw_bytes;
+};
+
+// LRU cache of full distance vectors, keyed by source node.
+//
+// Vectors are stored compressed in blocks of RESULT_CACHE_BLOCK distances. A block of
+// unreachable nodes costs only its header; any other block stores every distance as its
+// difference to the smallest distance of the block, bit-packed with the fewest bits that
+// fit the largest difference. A single distance can be decoded without touching the rest
+// of the vector. Entries carry the graph version they were computed for and are dropped
+// when looked up with a newer version. The cache is safe to use from several threads.
+class ResultCache
+{
+public:
+	explicit ResultCache(size_t memory_budget_bytes);
+	~ResultCache();
+
+	bool lookupDistance(int source, int target, unsigned long long graph_version, long *distance);
+	bool lookup(int source, unsigned long long graph_version, std::vector<long> &distances);
+	void insert(int source, unsigned long long graph_version, const long *distances, int count,
+				int stride = 1);
+	void clear();
+	CacheStats stats();
+
+private:
+	struct BlockHeader
+	{
+		int64_t base;
+		uint64_t bit_offset;
+		// 0 means every node of the block is unreachable
+		uint8_t bits;
+	};
+
+	struct Entry
+	{
+		int source;
+		unsigned long long graph_version;
+		int count;
+		std::vector<BlockHeader> blocks;
+		std::vector<uint64_t> packed;
+
+		size_t bytes() const;
+	};
+
+	long decode(const Entry &entry, int node) const;
+	bool findCurrent(int source, unsigned long long graph_version, std::list<Entry>::iterator *found);
+	void erase(std::list<Entry>::iterator entry);
+
+	size_t memory_budget_bytes_;
+	pthread_mutex_t mutex_;
+	// most recently used entry first
+	std::list<Entry> lru_;
+	std::unordered_map<int, std::list<Entry>::iterator> index_;
+	CacheStats stats_;
+};
+
+#endif // RESULT_CACHE_H
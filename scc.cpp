@@ -0,0 +1,317 @@
+#include "scc.h"
+#include <algorithm> // For max and min
+#include <atomic>	 // For claiming nodes from several threads
+#include <utility>	 // For pair
+
+using namespace std;
+
+static const int SCC_UNASSIGNED = -1;
+
+// trimming passes before the forward-backward step, each one peels off another layer of
+// nodes without incoming or outgoing edges
+static const int SCC_TRIM_PASSES = 3;
+
+static bool hasUnassignedNeighbour(const CsrGraph &layout, int *component, int v)
+{
+	for (int j = layout.offsets[v]; j < layout.offsets[v + 1]; j++)
+	{
+		int u = layout.neighbours[j];
+		if (u != v && atomic_ref<int>(component[u]).load(memory_order_relaxed) == SCC_UNASSIGNED)
+			return true;
+	}
+	return false;
+}
+
+/**
+ * @brief Makes every node without an unassigned in- or out-neighbour a component of its
+ * own, in parallel.
+ *
+ * Such a node cannot lie on a cycle with other unassigned nodes. Sparse graphs often
+ * lose most of their nodes this way before the expensive steps.
+ */
+static void trimSingletons(const CsrGraph &csr, const CsrGraph &csc, ThreadPool &pool, int *component,
+						   atomic<int> &next_component)
+{
+	int no_of_nodes = csr.no_of_nodes;
+	int num_threads = pool.size();
+	int chunk = (no_of_nodes + num_threads - 1) / num_threads;
+
+	for (int pass = 0; pass < SCC_TRIM_PASSES; pass++)
+	{
+		atomic<bool> trimmed(false);
+		pool.run([&](int tid)
+		{
+			bool local = false;
+			for (int v = tid * chunk; v < min(no_of_nodes, (tid + 1) * chunk); v++)
+			{
+				if (component[v] != SCC_UNASSIGNED)
+					continue;
+				if (!hasUnassignedNeighbour(csc, component, v) || !hasUnassignedNeighbour(csr, component, v))
+				{
+					atomic_ref<int>(component[v]).store(next_component.fetch_add(1), memory_order_relaxed);
+					local = true;
+				}
+			}
+			if (local)
+				trimmed.store(true);
+		});
+		if (!trimmed.load())
+			break;
+	}
+}
+
+/**
+ * @brief Marks the unassigned nodes reachable from pivot over the given layout with a
+ * parallel level-synchronous BFS.
+ */
+static void reachUnassigned(const CsrGraph &layout, const int *component, int pivot, ThreadPool &pool,
+							vector<char> &reached)
+{
+	int num_threads = pool.size();
+	vector<vector<int>> next(num_threads);
+	vector<int> frontier = {pivot};
+	reached[pivot] = 1;
+
+	while (!frontier.empty())
+	{
+		int frontier_size = frontier.size();
+		int chunk = (frontier_size + num_threads - 1) / num_threads;
+		pool.run([&](int tid)
+		{
+			next[tid].clear();
+			for (int i = tid * chunk; i < min(frontier_size, (tid + 1) * chunk); i++)
+			{
+				int u = frontier[i];
+				for (int j = layout.offsets[u]; j < layout.offsets[u + 1]; j++)
+				{
+					int v = layout.neighbours[j];
+					if (component[v] != SCC_UNASSIGNED || reached[v])
+						continue;
+					char unreached = 0;
+					if (atomic_ref<char>(reached[v]).compare_exchange_strong(unreached, 1))
+						next[tid].push_back(v);
+				}
+			}
+		});
+
+		frontier.clear();
+		for (const vector<int> &found : next)
+			frontier.insert(frontier.end(), found.begin(), found.end());
+	}
+}
+
+/**
+ * @brief Iterative Tarjan over the nodes that are still unassigned.
+ *
+ * Assigned nodes form complete components already, so their edges are ignored.
+ */
+static void tarjan(const CsrGraph &csr, int *component, int *next_component)
+{
+	int no_of_nodes = csr.no_of_nodes;
+	vector<int> index(no_of_nodes, -1), low(no_of_nodes);
+	vector<char> on_stack(no_of_nodes, 0);
+	vector<int> stack;
+	// explicit call stack: node and the next outgoing edge to visit
+	vector<pair<int, int>> calls;
+	int counter = 0;
+
+	for (int root = 0; root < no_of_nodes; root++)
+	{
+		if (component[root] != SCC_UNASSIGNED || index[root] >= 0)
+			continue;
+
+		index[root] = low[root] = counter++;
+		stack.push_back(root);
+		on_stack[root] = 1;
+		calls.push_back({root, csr.offsets[root]});
+
+		while (!calls.empty())
+		{
+			int v = calls.back().first;
+			if (calls.back().second < csr.offsets[v + 1])
+			{
+				int w = csr.neighbours[calls.back().second++];
+				if (index[w] < 0)
+				{
+					if (component[w] != SCC_UNASSIGNED)
+						continue;
+					index[w] = low[w] = counter++;
+					stack.push_back(w);
+					on_stack[w] = 1;
+					calls.push_back({w, csr.offsets[w]});
+				}
+				else if (on_stack[w])
+					low[v] = min(low[v], index[w]);
+				continue;
+			}
+
+			calls.pop_back();
+			if (!calls.empty())
+				low[calls.back().first] = min(low[calls.back().first], low[v]);
+
+			if (low[v] == index[v])
+			{
+				int id = (*next_component)++;
+				int w;
+				do
+				{
+					w = stack.back();
+					stack.pop_back();
+					on_stack[w] = 0;
+					component[w] = id;
+				} while (w != v);
+			}
+		}
+	}
+}
+
+/**
+ * @brief Stable counting sort of items into groups, returning the group offsets.
+ */
+template <typename Item, typename GroupOf>
+static void groupBy(const vector<Item> &items, int no_of_groups, GroupOf group_of, vector<int> &begin,
+					vector<Item> &grouped)
+{
+	begin.assign(no_of_groups + 1, 0);
+	for (const Item &item : items)
+		begin[group_of(item) + 1]++;
+	for (int g = 0; g < no_of_groups; g++)
+		begin[g + 1] += begin[g];
+
+	vector<int> position(begin.begin(), begin.end() - 1);
+	grouped.resize(items.size());
+	for (const Item &item : items)
+		grouped[position[group_of(item)]++] = item;
+}
+
+/**
+ * @brief Finds the strongly connected components of a graph and layers their
+ * condensation DAG.
+ *
+ * Parallel trimming removes the trivial components first. A forward and a backward
+ * parallel BFS from the unassigned node with the most in- and out-edges then extract the
+ * component of that node, which in real-world graphs is usually the giant one; an
+ * iterative Tarjan finds the rest. The condensation is layered with Kahn's algorithm and
+ * the edges are grouped into the edges inside each component and the edges leaving it.
+ *
+ * @param graph The edge list the layouts were built from.
+ * @param csr Outgoing layout of the graph, its node count is used.
+ * @param csc Incoming layout of the graph.
+ * @param pool Threads for trimming and the BFS.
+ * @param scc Receives the decomposition.
+ */
+void decomposeScc(const Graph *graph, const CsrGraph &csr, const CsrGraph &csc, ThreadPool &pool,
+				  SccDecomposition *scc)
+{
+	int no_of_nodes = csr.no_of_nodes;
+	int num_threads = pool.size();
+	int chunk = (no_of_nodes + num_threads - 1) / num_threads;
+	vector<int> raw(no_of_nodes, SCC_UNASSIGNED);
+	atomic<int> next_component(0);
+
+	trimSingletons(csr, csc, pool, raw.data(), next_component);
+
+	// pivot for the forward-backward step
+	vector<pair<long long, int>> best(num_threads, {-1, -1});
+	pool.run([&](int tid)
+	{
+		for (int v = tid * chunk; v < min(no_of_nodes, (tid + 1) * chunk); v++)
+		{
+			long long score = (long long)(csr.offsets[v + 1] - csr.offsets[v]) * (csc.offsets[v + 1] - csc.offsets[v]);
+			if (raw[v] == SCC_UNASSIGNED && score > best[tid].first)
+				best[tid] = {score, v};
+		}
+	});
+	int pivot = max_element(best.begin(), best.end())->second;
+
+	if (pivot >= 0)
+	{
+		vector<char> forward(no_of_nodes, 0), backward(no_of_nodes, 0);
+		reachUnassigned(csr, raw.data(), pivot, pool, forward);
+		reachUnassigned(csc, raw.data(), pivot, pool, backward);
+
+		int giant = next_component.fetch_add(1);
+		pool.run([&](int tid)
+		{
+			for (int v = tid * chunk; v < min(no_of_nodes, (tid + 1) * chunk); v++)
+			{
+				if (forward[v] && backward[v])
+					raw[v] = giant;
+			}
+		});
+	}
+
+	int no_of_components = next_component.load();
+	tarjan(csr, raw.data(), &no_of_components);
+
+	// condensation edges and in-degrees, by the unordered component ids
+	vector<Edge> cross_edges, internal_edges;
+	for (int i = 0; i < graph->no_of_edges; i++)
+	{
+		const Edge &edge = graph->edge[i];
+		if (raw[edge.source] != raw[edge.destination])
+			cross_edges.push_back(edge);
+		else
+			internal_edges.push_back(edge);
+	}
+	vector<int> cross_begin;
+	vector<Edge> cross_grouped;
+	groupBy(cross_edges, no_of_components, [&raw](const Edge &edge) { return raw[edge.source]; }, cross_begin,
+			cross_grouped);
+
+	vector<int> in_degree(no_of_components, 0);
+	for (const Edge &edge : cross_grouped)
+		in_degree[raw[edge.destination]]++;
+
+	// Kahn's algorithm one level at a time
+	vector<int> order;
+	order.reserve(no_of_components);
+	for (int c = 0; c < no_of_components; c++)
+	{
+		if (in_degree[c] == 0)
+			order.push_back(c);
+	}
+	scc->level_begin.assign(1, 0);
+	for (size_t level_start = 0; level_start < order.size();)
+	{
+		size_t level_end = order.size();
+		for (size_t i = level_start; i < level_end; i++)
+		{
+			int c = order[i];
+			for (int j = cross_begin[c]; j < cross_begin[c + 1]; j++)
+			{
+				if (--in_degree[raw[cross_grouped[j].destination]] == 0)
+					order.push_back(raw[cross_grouped[j].destination]);
+			}
+		}
+		scc->level_begin.push_back(level_end);
+		level_start = level_end;
+	}
+
+	vector<int> renumbered(no_of_components);
+	for (int i = 0; i < no_of_components; i++)
+		renumbered[order[i]] = i;
+
+	scc->no_of_components = no_of_components;
+	scc->no_of_levels = scc->level_begin.size() - 1;
+	scc->component.resize(no_of_nodes);
+	pool.run([&](int tid)
+	{
+		for (int v = tid * chunk; v < min(no_of_nodes, (tid + 1) * chunk); v++)
+			scc->component[v] = renumbered[raw[v]];
+	});
+
+	const vector<int> &component = scc->component;
+	vector<int> all_nodes(no_of_nodes);
+	for (int v = 0; v < no_of_nodes; v++)
+		all_nodes[v] = v;
+	groupBy(all_nodes, no_of_components, [&component](int v) { return component[v]; }, scc->node_begin, scc->nodes);
+
+	auto sourceComponent = [&component](const Edge &edge) { return component[edge.source]; };
+	groupBy(internal_edges, no_of_components, sourceComponent, scc->internal_begin, scc->internal_edges);
+	groupBy(cross_edges, no_of_components, sourceComponent, scc->cross_begin, scc->cross_edges);
+
+	scc->largest_component = 0;
+	for (int c = 0; c < no_of_components; c++)
+		scc->largest_component = max(scc->largest_component, scc->node_begin[c + 1] - scc->node_begin[c]);
+}
@@ -0,0 +1,38 @@
+#ifndef SCC_H
+#define SCC_H
+
+#include <vector>
+#include "graph.h"
+#include "csr.h"
+#include "thread_pool.h"
+
+// Strongly connected components of a graph and their condensation DAG.
+//
+// Components are numbered level by level: level 0 holds the components without incoming
+// edges from other components, and a component's level is one more than the highest
+// level among the components with edges into it. Every edge between two components
+// therefore goes from a lower to a higher level, and the components of one level are
+// independent of each other.
+struct SccDecomposition
+{
+	int no_of_components;
+	int no_of_levels;
+	// component of every node
+	std::vector<int> component;
+	// the components of level l are [level_begin[l], level_begin[l + 1])
+	std::vector<int> level_begin;
+	// the nodes of component c are nodes[node_begin[c]] .. nodes[node_begin[c + 1] - 1]
+	std::vector<int> node_begin;
+	std::vector<int> nodes;
+	// edges inside component c, and edges from c to later components, grouped the same way
+	std::vector<int> internal_begin;
+	std::vector<Edge> internal_edges;
+	std::vector<int> cross_begin;
+	std::vector<Edge> cross_edges;
+	int largest_component;
+};
+
+void decomposeScc(const Graph *graph, const CsrGraph &csr, const CsrGraph &csc, ThreadPool &pool,
+				  SccDecomposition *scc);
+
+#endif // SCC_H
@@ -0,0 +1,217 @@
+#include "sell.h"
+#include "sssp_c_api.h"
+#include <algorithm> // For max and stable_sort
+#include <cstdint>	 // For int64_t
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h> // For x86 gathers
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h> // For ARM-specific SIMD intrinsics
+#endif
+
+using namespace std;
+
+/**
+ * @brief Builds the SELL-C-sigma layout from the incoming edge lists.
+ *
+ * @param csc Incoming layout of the graph.
+ * @param sell The layout to fill, its arrays live in the arena and are released with it.
+ * @param arena Arena to allocate the arrays from.
+ * @return false if the arena ran out of memory, the layout is unusable then.
+ */
+bool buildSell(const CsrGraph &csc, SellGraph *sell, Arena *arena)
+{
+	int no_of_nodes = csc.no_of_nodes;
+	int no_of_rows = (no_of_nodes + SELL_CHUNK_HEIGHT - 1) / SELL_CHUNK_HEIGHT * SELL_CHUNK_HEIGHT;
+	int no_of_chunks = no_of_rows / SELL_CHUNK_HEIGHT;
+	auto degree = [&csc](int v) { return v < 0 ? 0 : csc.offsets[v + 1] - csc.offsets[v]; };
+
+	sell->no_of_nodes = no_of_nodes;
+	sell->no_of_rows = no_of_rows;
+	sell->no_of_chunks = no_of_chunks;
+	sell->node_of_row = arena->allocateArray<int>(max(no_of_rows, 1));
+	sell->row_of_node = arena->allocateArray<int>(max(no_of_nodes, 1));
+	sell->chunk_offsets = arena->allocateArray<long long>(no_of_chunks + 1);
+	sell->chunk_lengths = arena->allocateArray<int>(max(no_of_chunks, 1));
+	if (sell->node_of_row == NULL || sell->row_of_node == NULL || sell->chunk_offsets == NULL ||
+		sell->chunk_lengths == NULL)
+		return false;
+
+	// longest rows first within every window of SELL_SIGMA rows
+	for (int window = 0; window < no_of_rows; window += SELL_SIGMA)
+	{
+		int end = min(no_of_rows, window + SELL_SIGMA);
+		for (int r = window; r < end; r++)
+			sell->node_of_row[r] = r < no_of_nodes ? r : -1;
+		stable_sort(sell->node_of_row + window, sell->node_of_row + end,
+					[&degree](int a, int b) { return degree(a) > degree(b); });
+	}
+	for (int r = 0; r < no_of_rows; r++)
+	{
+		if (sell->node_of_row[r] >= 0)
+			sell->row_of_node[sell->node_of_row[r]] = r;
+	}
+
+	sell->chunk_offsets[0] = 0;
+	for (int k = 0; k < no_of_chunks; k++)
+	{
+		int length = 0;
+		for (int lane = 0; lane < SELL_CHUNK_HEIGHT; lane++)
+			length = max(length, degree(sell->node_of_row[k * SELL_CHUNK_HEIGHT + lane]));
+		sell->chunk_lengths[k] = length;
+		sell->chunk_offsets[k + 1] = sell->chunk_offsets[k] + (long long)length * SELL_CHUNK_HEIGHT;
+	}
+	sell->no_of_entries = sell->chunk_offsets[no_of_chunks];
+	sell->columns = arena->allocateArray<int>(max(sell->no_of_entries, 1LL));
+	sell->weights = arena->allocateArray<int>(max(sell->no_of_entries, 1LL));
+	if (sell->columns == NULL || sell->weights == NULL)
+		return false;
+
+	for (int k = 0; k < no_of_chunks; k++)
+	{
+		for (int lane = 0; lane < SELL_CHUNK_HEIGHT; lane++)
+		{
+			int row = k * SELL_CHUNK_HEIGHT + lane;
+			int v = sell->node_of_row[row];
+			for (int j = 0; j < sell->chunk_lengths[k]; j++)
+			{
+				long long entry = sell->chunk_offsets[k] + (long long)j * SELL_CHUNK_HEIGHT + lane;
+				if (j < degree(v))
+				{
+					sell->columns[entry] = sell->row_of_node[csc.neighbours[csc.offsets[v] + j]];
+					sell->weights[entry] = csc.weights[csc.offsets[v] + j];
+				}
+				else
+				{
+					sell->columns[entry] = row;
+					sell->weights[entry] = 0;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief One min-plus row update for every row of a chunk.
+ *
+ * next[r] = min(current[r], min over the entries (s, w) of row r of current[s] + w), only
+ * counting sources with a finite distance. Each vector lane owns one row, so a chunk needs
+ * gathers but no scatters and no atomics.
+ */
+static inline void relaxChunk(const SellGraph &sell, const long *current, long *next, int chunk)
+{
+	const int *columns = sell.columns + sell.chunk_offsets[chunk];
+	const int *weights = sell.weights + sell.chunk_offsets[chunk];
+	int length = sell.chunk_lengths[chunk];
+	int row = chunk * SELL_CHUNK_HEIGHT;
+
+#if defined(__AVX512F__)
+	const __m512i infinity = _mm512_set1_epi64(SSSP_INFINITY);
+	__m512i best = _mm512_loadu_si512(current + row);
+	for (int j = 0; j < length; j++)
+	{
+		__m256i index = _mm256_loadu_si256((const __m256i *)(columns + j * SELL_CHUNK_HEIGHT));
+		// the masked forms with a zero source compile to the same instructions, but spare
+		// gcc's headers their undefined pass-through vector and its -Wmaybe-uninitialized
+		__m512i source = _mm512_mask_i32gather_epi64(_mm512_setzero_si512(), 0xFF, index, current, 8);
+		__m512i weight = _mm512_maskz_cvtepi32_epi64(0xFF, _mm256_loadu_si256((const __m256i *)(weights + j * SELL_CHUNK_HEIGHT)));
+		__mmask8 reached = _mm512_cmplt_epi64_mask(source, infinity);
+		best = _mm512_mask_min_epi64(best, reached, best, _mm512_add_epi64(source, weight));
+	}
+	_mm512_storeu_si512(next + row, best);
+#elif defined(__AVX2__)
+	// two vectors of four rows, AVX2 has no 64-bit min so compare and blend
+	const __m256i infinity = _mm256_set1_epi64x(SSSP_INFINITY);
+	__m256i best[2];
+	for (int half = 0; half < 2; half++)
+		best[half] = _mm256_loadu_si256((const __m256i *)(current + row + 4 * half));
+	for (int j = 0; j < length; j++)
+	{
+		for (int half = 0; half < 2; half++)
+		{
+			int entry = j * SELL_CHUNK_HEIGHT + 4 * half;
+			__m128i index = _mm_loadu_si128((const __m128i *)(columns + entry));
+			__m256i source = _mm256_i32gather_epi64((const long long *)current, index, 8);
+			__m256i weight = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)(weights + entry)));
+			__m256i candidate = _mm256_add_epi64(source, weight);
+			__m256i improve = _mm256_and_si256(_mm256_cmpgt_epi64(infinity, source), _mm256_cmpgt_epi64(best[half], candidate));
+			best[half] = _mm256_blendv_epi8(best[half], candidate, improve);
+		}
+	}
+	for (int half = 0; half < 2; half++)
+		_mm256_storeu_si256((__m256i *)(next + row + 4 * half), best[half]);
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+	// four vectors of two rows, NEON has no gather so the lanes are loaded one by one
+	const int64x2_t infinity = vdupq_n_s64(SSSP_INFINITY);
+	const int64_t *distances = (const int64_t *)current;
+	int64x2_t best[4];
+	for (int quarter = 0; quarter < 4; quarter++)
+		best[quarter] = vld1q_s64(distances + row + 2 * quarter);
+	for (int j = 0; j < length; j++)
+	{
+		for (int quarter = 0; quarter < 4; quarter++)
+		{
+			int entry = j * SELL_CHUNK_HEIGHT + 2 * quarter;
+			int64x2_t source = vcombine_s64(vld1_s64(distances + columns[entry]), vld1_s64(distances + columns[entry + 1]));
+			int64x2_t candidate = vaddq_s64(source, vmovl_s32(vld1_s32(weights + entry)));
+			uint64x2_t improve = vandq_u64(vcltq_s64(source, infinity), vcltq_s64(candidate, best[quarter]));
+			best[quarter] = vbslq_s64(improve, candidate, best[quarter]);
+		}
+	}
+	for (int quarter = 0; quarter < 4; quarter++)
+		vst1q_s64((int64_t *)next + row + 2 * quarter, best[quarter]);
+#else
+	long best[SELL_CHUNK_HEIGHT];
+	for (int lane = 0; lane < SELL_CHUNK_HEIGHT; lane++)
+		best[lane] = current[row + lane];
+	for (int j = 0; j < length; j++)
+	{
+		for (int lane = 0; lane < SELL_CHUNK_HEIGHT; lane++)
+		{
+			long source = current[columns[j * SELL_CHUNK_HEIGHT + lane]];
+			long candidate = source + weights[j * SELL_CHUNK_HEIGHT + lane];
+			if (source < SSSP_INFINITY && candidate < best[lane])
+				best[lane] = candidate;
+		}
+	}
+	for (int lane = 0; lane < SELL_CHUNK_HEIGHT; lane++)
+		next[row + lane] = best[lane];
+#endif
+}
+
+/**
+ * @brief One Jacobi-style min-plus SpMV round over the chunks [chunk_begin, chunk_end).
+ *
+ * Reads only current and writes only the rows of the given chunks in next, so threads
+ * working on disjoint chunk ranges need no synchronisation.
+ *
+ * @return true if any distance of these rows was lowered.
+ */
+bool sellRelaxChunks(const SellGraph &sell, const long *current, long *next, int chunk_begin, int chunk_end)
+{
+	bool changed = false;
+	for (int k = chunk_begin; k < chunk_end; k++)
+	{
+		relaxChunk(sell, current, next, k);
+		for (int row = k * SELL_CHUNK_HEIGHT; row < (k + 1) * SELL_CHUNK_HEIGHT; row++)
+			changed |= next[row] != current[row];
+	}
+	return changed;
+}
+
+/**
+ * @brief Name of the instruction set the SpMV kernel was compiled for.
+ */
+const char *sellKernelBackend()
+{
+#if defined(__AVX512F__)
+	return "avx512";
+#elif defined(__AVX2__)
+	return "avx2";
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+	return "neon";
+#else
+	return "scalar";
+#endif
+}
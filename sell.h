@@ -0,0 +1,45 @@
+#ifndef SELL_H
+#define SELL_H
+
+#include "csr.h"
+#include "arena.h"
+
+// rows per chunk of the SELL-C-sigma layout, one vector of 64-bit distances on AVX-512
+const int SELL_CHUNK_HEIGHT = 8;
+
+// rows sorted by length together, a multiple of SELL_CHUNK_HEIGHT
+const int SELL_SIGMA = 256;
+
+// SELL-C-sigma (sliced ELLPACK) layout of the incoming edges, for pull-based min-plus
+// SpMV.
+//
+// Row r is the node node_of_row[r], its entries are the node's incoming edges. Rows are
+// sorted by length, longest first, within windows of SELL_SIGMA rows, and grouped into
+// chunks of SELL_CHUNK_HEIGHT rows. Chunk k holds chunk_lengths[k] columns starting at
+// chunk_offsets[k]; column j of the chunk stores the entry j of each of its rows next to
+// each other, so one vector load fetches an entry for every row of the chunk. Shorter
+// rows are padded with entries pointing at the row itself with weight 0, which never
+// lower a distance. Sources are stored as row numbers, so the distance vector of a solve
+// lives in row order and a chunk's results are one contiguous store.
+struct SellGraph
+{
+	int no_of_nodes;
+	// no_of_nodes rounded up to whole chunks
+	int no_of_rows;
+	int no_of_chunks;
+	long long *chunk_offsets;
+	int *chunk_lengths;
+	int *columns;
+	int *weights;
+	// node of every row, -1 for the padding rows of the last chunk, and its inverse
+	int *node_of_row;
+	int *row_of_node;
+	// stored entries including padding, compared with the edge count to judge the padding
+	long long no_of_entries;
+};
+
+bool buildSell(const CsrGraph &csc, SellGraph *sell, Arena *arena);
+bool sellRelaxChunks(const SellGraph &sell, const long *current, long *next, int chunk_begin, int chunk_end);
+const char *sellKernelBackend();
+
+#endif // SELL_H
@@ -0,0 +1,119 @@
+#include "shared_memory_transport.h"
+#include <cstring>	  // For memcpy
+#include <sys/mman.h> // For shared anonymous mappings
+
+using namespace std;
+
+/**
+ * @brief Maps the mailboxes shared by all partitions. Must be called before forking.
+ *
+ * @param no_of_partitions Number of worker processes, at most SHARED_MEMORY_MAX_PARTITIONS.
+ * @param mailbox_capacity Updates partition from may send to partition to in one round, at
+ * index from * no_of_partitions + to.
+ */
+SharedMemoryTransport::SharedMemoryTransport(int no_of_partitions, const vector<long long> &mailbox_capacity)
+	: no_of_partitions_(no_of_partitions), rank_(-1), region_(NULL), region_bytes_(0),
+	  header_(NULL), mailboxes_(NULL), slots_(NULL)
+{
+	if (no_of_partitions < 1 || no_of_partitions > SHARED_MEMORY_MAX_PARTITIONS ||
+		(long long)mailbox_capacity.size() != (long long)no_of_partitions * no_of_partitions)
+		return;
+
+	long long total_slots = 0;
+	for (long long capacity : mailbox_capacity)
+		total_slots += capacity;
+
+	size_t mailbox_bytes = (size_t)no_of_partitions * no_of_partitions * sizeof(Mailbox);
+	region_bytes_ = sizeof(Header) + mailbox_bytes + (size_t)total_slots * sizeof(BoundaryUpdate);
+	void *region = mmap(NULL, region_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (region == MAP_FAILED)
+		return;
+
+	region_ = region;
+	header_ = (Header *)region_;
+	mailboxes_ = (Mailbox *)((char *)region_ + sizeof(Header));
+	slots_ = (BoundaryUpdate *)((char *)mailboxes_ + mailbox_bytes);
+
+	long long offset = 0;
+	for (int i = 0; i < no_of_partitions * no_of_partitions; i++)
+	{
+		mailboxes_[i].count = 0;
+		mailboxes_[i].capacity = mailbox_capacity[i];
+		mailboxes_[i].offset = offset;
+		offset += mailbox_capacity[i];
+	}
+
+	pthread_barrierattr_t attr;
+	pthread_barrierattr_init(&attr);
+	pthread_barrierattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+	pthread_barrier_init(&header_->barrier, &attr, no_of_partitions);
+	pthread_barrierattr_destroy(&attr);
+}
+
+/**
+ * @brief Unmaps the region in the calling process. The parent destroys the barrier after
+ * all workers have exited.
+ */
+SharedMemoryTransport::~SharedMemoryTransport()
+{
+	if (region_ == NULL)
+		return;
+	if (rank_ < 0)
+		pthread_barrier_destroy(&header_->barrier);
+	munmap(region_, region_bytes_);
+}
+
+void SharedMemoryTransport::attach(int rank)
+{
+	rank_ = rank;
+}
+
+bool SharedMemoryTransport::send(int to, const BoundaryUpdate *updates, int count)
+{
+	Mailbox *box = mailbox(rank_, to);
+	if (box->count + count > box->capacity)
+		return false;
+
+	memcpy(slots_ + box->offset + box->count, updates, (size_t)count * sizeof(BoundaryUpdate));
+	box->count += count;
+	return true;
+}
+
+/**
+ * @brief Collects this round's updates for the calling partition.
+ *
+ * The first barrier publishes every sender's mailboxes, the second one makes sure all
+ * receivers are done reading before the senders empty them for the next round.
+ */
+void SharedMemoryTransport::exchange(vector<BoundaryUpdate> &received)
+{
+	received.clear();
+	pthread_barrier_wait(&header_->barrier);
+
+	for (int from = 0; from < no_of_partitions_; from++)
+	{
+		const Mailbox *box = mailbox(from, rank_);
+		received.insert(received.end(), slots_ + box->offset, slots_ + box->offset + box->count);
+	}
+
+	pthread_barrier_wait(&header_->barrier);
+	for (int to = 0; to < no_of_partitions_; to++)
+		mailbox(rank_, to)->count = 0;
+}
+
+/**
+ * @brief Publishes this partition's vote and reads everyone's.
+ *
+ * The votes are not overwritten before everybody has read them, since the next vote
+ * comes after the barriers of the next exchange().
+ */
+bool SharedMemoryTransport::vote(bool changed)
+{
+	header_->votes[rank_] = changed;
+	pthread_barrier_wait(&header_->barrier);
+
+	bool any_changed = false;
+	for (int p = 0; p < no_of_partitions_; p++)
+		any_changed = any_changed || header_->votes[p];
+	return any_changed;
+}
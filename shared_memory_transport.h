@@ -0,0 +1,60 @@
+#ifndef SHARED_MEMORY_TRANSPORT_H
+#define SHARED_MEMORY_TRANSPORT_H
+
+#include <pthread.h>
+#include <vector>
+#include "partition_transport.h"
+
+// most worker processes one shared-memory transport can connect
+const int SHARED_MEMORY_MAX_PARTITIONS = 64;
+
+// Transport for worker processes forked from one parent.
+//
+// The parent creates the transport before forking, so every worker inherits the same
+// shared anonymous mapping. It holds one mailbox per ordered pair of partitions, written
+// only by the sender and read only by the receiver, a process-shared barrier and the
+// convergence votes. Mailboxes are sized up front from the number of distinct boundary
+// vertices each partition can address in another one, so a round never overflows them.
+class SharedMemoryTransport : public PartitionTransport
+{
+public:
+	SharedMemoryTransport(int no_of_partitions, const std::vector<long long> &mailbox_capacity);
+	~SharedMemoryTransport();
+
+	bool valid() const { return region_ != NULL; }
+
+	void attach(int rank);
+	int rank() const { return rank_; }
+	int size() const { return no_of_partitions_; }
+	bool send(int to, const BoundaryUpdate *updates, int count);
+	void exchange(std::vector<BoundaryUpdate> &received);
+	bool vote(bool changed);
+
+private:
+	struct Header
+	{
+		pthread_barrier_t barrier;
+		// last vote of every partition
+		int votes[SHARED_MEMORY_MAX_PARTITIONS];
+	};
+
+	struct Mailbox
+	{
+		long long count;
+		long long capacity;
+		// offset of the first slot, in BoundaryUpdates from the start of the slot area
+		long long offset;
+	};
+
+	Mailbox *mailbox(int from, int to) const { return mailboxes_ + (size_t)from * no_of_partitions_ + to; }
+
+	int no_of_partitions_;
+	int rank_;
+	void *region_;
+	size_t region_bytes_;
+	Header *header_;
+	Mailbox *mailboxes_;
+	BoundaryUpdate *slots_;
+};
+
+#endif // SHARED_MEMORY_TRANSPORT_H
@@ -0,0 +1,194 @@
+#include "sssp_c_api.h"
+#include "sssp_solver.h"
+#include <algorithm> // For max
+#include <cstdlib>	 // For malloc
+#include <cstring>	 // For memcpy
+#include <new>		 // For bad_alloc
+
+using namespace std;
+
+// the C handle is the C++ solver itself
+struct sssp_solver
+{
+	Solver solver;
+
+	explicit sssp_solver(int num_threads) : solver(num_threads) {}
+};
+
+/**
+ * @brief Runs a solver call and turns C++ exceptions into status codes, none may cross
+ * the C boundary.
+ */
+template <typename Function>
+static int guarded(Function function)
+{
+	try
+	{
+		return function();
+	}
+	catch (const bad_alloc &)
+	{
+		return SSSP_ERROR_OUT_OF_MEMORY;
+	}
+	catch (...)
+	{
+		return SSSP_ERROR_INTERNAL;
+	}
+}
+
+/**
+ * @brief Creates a solver with its own pool of num_threads worker threads.
+ *
+ * @param num_threads Number of threads used by every solve, at least 1.
+ * @return The new solver, to be released with sssp_solver_destroy, or NULL on failure.
+ */
+sssp_solver *sssp_solver_create(int num_threads)
+{
+	try
+	{
+		return new sssp_solver(num_threads);
+	}
+	catch (...)
+	{
+		return NULL;
+	}
+}
+
+void sssp_solver_destroy(sssp_solver *solver)
+{
+	delete solver;
+}
+
+/**
+ * @brief Loads a graph from a .mtx or .bin file, replacing the current graph.
+ */
+int sssp_solver_load(sssp_solver *solver, const char *input_graph_path)
+{
+	if (solver == NULL || input_graph_path == NULL)
+		return SSSP_ERROR_INVALID_ARGUMENT;
+	return guarded([&]() { return solver->solver.load(input_graph_path); });
+}
+
+/**
+ * @brief Loads a graph from three parallel edge arrays, replacing the current graph.
+ *
+ * The arrays are copied, the caller keeps ownership of them.
+ *
+ * @return SSSP_OK, SSSP_ERROR_INVALID_ARGUMENT if a node id is outside [0, no_of_nodes),
+ * or SSSP_ERROR_OUT_OF_MEMORY.
+ */
+int sssp_solver_load_edges(sssp_solver *solver, int no_of_nodes, int no_of_edges,
+						   const int *sources, const int *destinations, const int *weights)
+{
+	if (solver == NULL || no_of_nodes < 0 || no_of_edges < 0 ||
+		(no_of_edges > 0 && (sources == NULL || destinations == NULL || weights == NULL)))
+		return SSSP_ERROR_INVALID_ARGUMENT;
+
+	for (int i = 0; i < no_of_edges; i++)
+	{
+		if (sources[i] < 0 || sources[i] >= no_of_nodes || destinations[i] < 0 || destinations[i] >= no_of_nodes)
+			return SSSP_ERROR_INVALID_ARGUMENT;
+	}
+
+	Graph *graph = (Graph *)malloc(sizeof(Graph));
+	if (graph == NULL)
+		return SSSP_ERROR_OUT_OF_MEMORY;
+	graph->no_of_nodes = no_of_nodes;
+	graph->no_of_edges = no_of_edges;
+	graph->edge = (Edge *)malloc((size_t)max(no_of_edges, 1) * sizeof(Edge));
+	if (graph->edge == NULL)
+	{
+		free(graph);
+		return SSSP_ERROR_OUT_OF_MEMORY;
+	}
+	for (int i = 0; i < no_of_edges; i++)
+	{
+		graph->edge[i].source = sources[i];
+		graph->edge[i].destination = destinations[i];
+		graph->edge[i].weight = weights[i];
+	}
+
+	return guarded([&]() { return solver->solver.loadGraph(graph); });
+}
+
+/**
+ * @brief Selects the relaxation engine used by the following solves.
+ *
+ * @param engine One of the SSSP_ENGINE_* constants.
+ */
+int sssp_solver_set_engine(sssp_solver *solver, int engine)
+{
+	if (solver == NULL)
+		return SSSP_ERROR_INVALID_ARGUMENT;
+	return guarded([&]() { return solver->solver.setEngine((SolverEngine)engine); });
+}
+
+/**
+ * @brief Switches NUMA-aware thread pinning and memory placement on (non-zero) or off.
+ */
+int sssp_solver_set_numa_aware(sssp_solver *solver, int numa_aware)
+{
+	if (solver == NULL)
+		return SSSP_ERROR_INVALID_ARGUMENT;
+	return guarded([&]()
+	{
+		solver->solver.setNumaAware(numa_aware != 0);
+		return SSSP_OK;
+	});
+}
+
+/**
+ * @brief Computes the distances from source_node_id to all nodes.
+ *
+ * @return SSSP_OK, SSSP_NEGATIVE_CYCLE or a negative error code.
+ */
+int sssp_solver_solve(sssp_solver *solver, int source_node_id)
+{
+	if (solver == NULL)
+		return SSSP_ERROR_INVALID_ARGUMENT;
+	return guarded([&]() { return solver->solver.solve(source_node_id); });
+}
+
+/**
+ * @brief Writes a checkpoint every interval_rounds rounds of a solve, 0 disables it.
+ */
+int sssp_solver_set_checkpoint(sssp_solver *solver, const char *path, int interval_rounds)
+{
+	if (solver == NULL || (path == NULL && interval_rounds != 0))
+		return SSSP_ERROR_INVALID_ARGUMENT;
+	return guarded([&]() { return solver->solver.setCheckpoint(path == NULL ? "" : path, interval_rounds); });
+}
+
+/**
+ * @brief Continues an interrupted solve from a checkpoint written for the loaded graph.
+ *
+ * @return Like sssp_solver_solve, or a negative error code if the checkpoint is unusable.
+ */
+int sssp_solver_resume(sssp_solver *solver, const char *path)
+{
+	if (solver == NULL || path == NULL)
+		return SSSP_ERROR_INVALID_ARGUMENT;
+	return guarded([&]() { return solver->solver.resume(path); });
+}
+
+int sssp_solver_node_count(const sssp_solver *solver)
+{
+	return solver == NULL ? 0 : solver->solver.nodeCount();
+}
+
+/**
+ * @brief Copies the distances of the last solve into a caller provided array.
+ *
+ * @param distances Output array, unreachable nodes are set to SSSP_INFINITY.
+ * @param count Capacity of the array, at most that many distances are copied.
+ * @return The number of distances copied, or a negative error code.
+ */
+int sssp_solver_get_distances(const sssp_solver *solver, long *distances, int count)
+{
+	if (solver == NULL || distances == NULL || count < 0)
+		return SSSP_ERROR_INVALID_ARGUMENT;
+
+	int copied = count < solver->solver.nodeCount() ? count : solver->solver.nodeCount();
+	memcpy(distances, solver->solver.distances(), (size_t)copied * sizeof(long));
+	return copied;
+}
@@ -0,0 +1,56 @@
+#ifndef SSSP_C_API_H
+#define SSSP_C_API_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// status codes returned by the solver
+#define SSSP_OK 0
+#define SSSP_NEGATIVE_CYCLE 1
+#define SSSP_ERROR_NO_GRAPH -1
+#define SSSP_ERROR_INVALID_SOURCE -2
+#define SSSP_ERROR_LOAD_FAILED -3
+#define SSSP_ERROR_INVALID_ARGUMENT -4
+#define SSSP_ERROR_WORKER_FAILED -5
+#define SSSP_ERROR_OUT_OF_MEMORY -6
+// an unexpected C++ exception was caught at the C boundary
+#define SSSP_ERROR_INTERNAL -7
+
+// relaxation engines, selected with sssp_solver_set_engine
+#define SSSP_ENGINE_BELLMAN_FORD 0
+#define SSSP_ENGINE_PUSH_PULL 1
+#define SSSP_ENGINE_ASYNC 2
+#define SSSP_ENGINE_DIJKSTRA 3
+#define SSSP_ENGINE_AUTO 4
+#define SSSP_ENGINE_SCC 5
+#define SSSP_ENGINE_SPMV 6
+#define SSSP_ENGINE_TARJAN 7
+
+// distance reported for nodes that are not reachable from the source
+#define SSSP_INFINITY (2147483647L - 100)
+
+	// opaque handle to a long-lived solver
+	typedef struct sssp_solver sssp_solver;
+
+	sssp_solver *sssp_solver_create(int num_threads);
+	void sssp_solver_destroy(sssp_solver *solver);
+
+	int sssp_solver_load(sssp_solver *solver, const char *input_graph_path);
+	int sssp_solver_load_edges(sssp_solver *solver, int no_of_nodes, int no_of_edges,
+							   const int *sources, const int *destinations, const int *weights);
+
+	int sssp_solver_set_engine(sssp_solver *solver, int engine);
+	int sssp_solver_set_numa_aware(sssp_solver *solver, int numa_aware);
+	int sssp_solver_solve(sssp_solver *solver, int source_node_id);
+	int sssp_solver_set_checkpoint(sssp_solver *solver, const char *path, int interval_rounds);
+	int sssp_solver_resume(sssp_solver *solver, const char *path);
+	int sssp_solver_node_count(const sssp_solver *solver);
+	int sssp_solver_get_distances(const sssp_solver *solver, long *distances, int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SSSP_C_API_H
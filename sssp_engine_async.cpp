@@ -0,0 +1,153 @@
+#include "sssp_solver.h"
+#include "distance_atomics.h"
+#include <algorithm> // For max
+#include <atomic>	 // For the termination protocol
+#include <sched.h>	 // For sched_yield
+
+using namespace std;
+
+/**
+ * @brief Asynchronous (chaotic) Bellman-Ford.
+ *
+ * There are no global rounds: every thread sweeps its edge partition over and over,
+ * always reading the newest distances, so an improvement can travel along many edges
+ * within one sweep and no thread ever waits at a barrier.
+ *
+ * Termination is detected without a coordinator. A shared counter is incremented by a
+ * thread at the first improvement of each sweep, right after it marks itself busy and
+ * before the improved distance is published, so no other thread can see the improvement
+ * while the counter and the flags still look clean. It is incremented again at the end
+ * of an improving sweep, so a sweep that overlapped later improvements of the same sweep
+ * cannot count as clean either. A
+ * sweep without improvement marks the thread clean as of the counter value read when the
+ * sweep started. A thread that just finished a clean sweep started at value e checks, in
+ * two phases, that the counter still reads e, that every thread is clean as of e, and
+ * that the counter still reads e afterwards. Then every edge was scanned after the last
+ * improvement and found not relaxable, so the distances are final.
+ *
+ * A negative cycle keeps lowering distances forever. It is detected early once a distance
+ * drops below the sum of all negative edge weights, which no simple path can undercut.
+ * That can take very long for a cycle of small weight, so the sweeps are also capped: a
+ * thread that has done 2 * no_of_nodes sweeps counts itself as capped but keeps sweeping
+ * (and keeps its clean flag current), and all threads stop once every one of them is
+ * capped. Threads run at different speeds, so the sweeps do not add up to a known number
+ * of Bellman-Ford rounds; the distances are only upper bounds at that point. The solve
+ * therefore finishes with synchronous rounds (relaxRound) until nothing changes, at most
+ * no_of_nodes - 1 of them, and then hasNegativeCycle() decides.
+ *
+ * rounds() reports the largest number of sweeps done by any thread, plus the
+ * synchronous rounds of a capped solve.
+ *
+ * @return SSSP_OK or SSSP_NEGATIVE_CYCLE.
+ */
+int Solver::solveAsync()
+{
+	long lower_bound = 0;
+	for (int i = 0; i < graph_->no_of_edges; i++)
+		lower_bound += min(0, graph_->edge[i].weight);
+
+	atomic<long long> modifications(0);
+	atomic<bool> done(false), negative_cycle(false), quiescent_exit(false);
+	// threads that reached max_sweeps, the solve stops when all of them have
+	atomic<int> capped(0);
+	int num_threads = pool_.size();
+	long long max_sweeps = 2LL * node_count_;
+	for (ThreadFlag &flag : thread_flags_)
+		flag.count = -1;
+
+	pool_.run([this, &modifications, &done, &negative_cycle, &quiescent_exit, &capped, num_threads, lower_bound,
+			   max_sweeps](int tid)
+	{
+		long *node_distances = distances_;
+		const Edge *edges = partition_edges_[tid];
+		int partition_size = partition_begin_[tid + 1] - partition_begin_[tid];
+		// sweep start value of the counter if the last sweep was clean, -1 while busy
+		atomic_ref<long long> clean_since(thread_flags_[tid].count);
+		long long sweeps = 0;
+
+		while (!done.load())
+		{
+			if (sweeps == max_sweeps && capped.fetch_add(1) + 1 == num_threads)
+			{
+				done.store(true);
+				break;
+			}
+
+			long long start = modifications.load();
+			bool improved = false;
+			sweeps++;
+
+			for (int j = 0; j < partition_size; j++)
+			{
+				const Edge &edge = edges[j];
+				long source_distance = loadDistance(&node_distances[edge.source]);
+				long candidate = source_distance + edge.weight;
+				if (source_distance >= SSSP_INFINITY)
+					continue;
+
+				// announce the first improvement of the sweep before publishing it
+				if (!improved && candidate < loadDistance(&node_distances[edge.destination]))
+				{
+					improved = true;
+					clean_since.store(-1);
+					modifications.fetch_add(1);
+				}
+
+				if (improved && atomicMinDistance(&node_distances[edge.destination], candidate))
+				{
+					if (candidate < lower_bound)
+					{
+						negative_cycle.store(true);
+						done.store(true);
+						break;
+					}
+				}
+			}
+
+			if (improved)
+			{
+				modifications.fetch_add(1);
+				continue;
+			}
+
+			clean_since.store(start);
+			if (modifications.load() == start)
+			{
+				bool quiescent = true;
+				for (ThreadFlag &flag : thread_flags_)
+				{
+					if (atomic_ref<long long>(flag.count).load() != start)
+					{
+						quiescent = false;
+						break;
+					}
+				}
+				if (quiescent && modifications.load() == start)
+				{
+					quiescent_exit.store(true);
+					done.store(true);
+					break;
+				}
+			}
+
+			// nothing to do here until others improve, leave the core to busy threads
+			sched_yield();
+		}
+
+		thread_flags_[tid].work = sweeps;
+	});
+
+	rounds_ = 0;
+	for (const ThreadFlag &flag : thread_flags_)
+		rounds_ = max(rounds_, (int)flag.work);
+
+	if (negative_cycle.load())
+		return SSSP_NEGATIVE_CYCLE;
+	if (!quiescent_exit.load())
+	{
+		for (int round = 1; round < node_count_ && relaxRound(); round++)
+			rounds_++;
+		return hasNegativeCycle() ? SSSP_NEGATIVE_CYCLE : SSSP_OK;
+	}
+	return SSSP_OK;
+}
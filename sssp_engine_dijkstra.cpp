@@ -0,0 +1,76 @@
+#include "sssp_solver.h"
+
+using namespace std;
+
+/**
+ * @brief Label-setting relaxation over the CSR layout with a monotone queue.
+ *
+ * Every node that is flagged in active is queued with its current distance, then nodes
+ * are settled in order of distance and relax their outgoing edges once. Entries whose
+ * key no longer matches the node's distance are stale and skipped.
+ */
+template <typename Queue>
+static void settleNodes(const CsrGraph &csr, long *node_distances, const char *active, int no_of_nodes,
+						Queue &queue)
+{
+	for (int v = 0; v < no_of_nodes; v++)
+	{
+		if (active[v] && node_distances[v] < SSSP_INFINITY)
+			queue.push(node_distances[v], v);
+	}
+
+	long key;
+	int u;
+	while (queue.pop(&key, &u))
+	{
+		if (key != node_distances[u])
+			continue;
+
+		for (int e = csr.offsets[u]; e < csr.offsets[u + 1]; e++)
+		{
+			int v = csr.neighbours[e];
+			long candidate = key + csr.weights[e];
+			if (candidate < node_distances[v])
+			{
+				node_distances[v] = candidate;
+				queue.push(candidate, v);
+			}
+		}
+	}
+}
+
+/**
+ * @brief Serial Dijkstra for graphs without negative weights.
+ *
+ * Runs in O(m + n * log C) with a radix heap, or O(m + n * C) worst case with Dial's
+ * buckets when the largest weight C is at most DIAL_MAX_WEIGHT, instead of the O(n * m)
+ * worst case of Bellman-Ford, and needs no threads. Dial's buckets need every queued
+ * key within C of the smallest one, which only holds when a fresh solve starts from the
+ * source alone, so resumed solves always use the radix heap.
+ *
+ * @return SSSP_OK; a graph without negative weights has no negative cycle.
+ */
+int Solver::solveDijkstra()
+{
+	if (!prepareCsr())
+		return SSSP_ERROR_OUT_OF_MEMORY;
+
+	int seeds = 0;
+	for (int v = 0; v < node_count_ && seeds < 2; v++)
+		seeds += changed_[v] != 0;
+
+	if (seeds == 1 && max_weight_ <= DIAL_MAX_WEIGHT)
+	{
+		dial_queue_.reset(max(max_weight_, 0));
+		settleNodes(csr_, distances_, changed_, node_count_, dial_queue_);
+	}
+	else
+	{
+		radix_heap_.reset();
+		settleNodes(csr_, distances_, changed_, node_count_, radix_heap_);
+	}
+
+	fill(changed_, changed_ + node_count_, 0);
+	rounds_ = 0;
+	return SSSP_OK;
+}
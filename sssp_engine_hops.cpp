@@ -0,0 +1,145 @@
+#include "sssp_solver.h"
+#include <algorithm> // For fill and min
+#include <atomic>	 // For atomic_ref
+
+using namespace std;
+
+/**
+ * @brief Hop-bounded distances from up to SOLVER_MAX_BATCH sources at once.
+ *
+ * After the call, hopDistance(lane, v) is the length of the shortest path from
+ * source_node_ids[lane] to v that uses at most max_hops edges, or SSSP_INFINITY if
+ * there is none. Every hop is one exact Bellman-Ford round: the new distances are
+ * computed from the previous hop's only and written to a second buffer, so a hop never
+ * sees improvements of the same hop. Only the nodes improved in the last hop (in any
+ * lane) are expanded: their out-neighbours are claimed as candidates, and each candidate
+ * pulls its incoming edges over the CSC layout into the next buffer. Pulling needs no
+ * atomics, and the lanes of a node are stored next to each other and padded to
+ * HOP_LANE_WIDTH, so every edge updates all sources with a few vector minimums.
+ *
+ * rounds() reports the hops done, fewer than max_hops if no distance changed earlier.
+ * Negative weights are allowed; with a bounded number of hops there is no negative cycle.
+ *
+ * @param source_node_ids One source per lane.
+ * @param count Number of sources, 1 to SOLVER_MAX_BATCH.
+ * @param max_hops Largest number of edges of a path, at least 0.
+ * @return SSSP_OK, SSSP_ERROR_NO_GRAPH, SSSP_ERROR_INVALID_SOURCE or
+ * SSSP_ERROR_INVALID_ARGUMENT.
+ */
+int Solver::solveHops(const int *source_node_ids, int count, int max_hops)
+{
+	if (graph_ == NULL)
+		return SSSP_ERROR_NO_GRAPH;
+	if (count < 1 || count > SOLVER_MAX_BATCH || max_hops < 0)
+		return SSSP_ERROR_INVALID_ARGUMENT;
+	for (int lane = 0; lane < count; lane++)
+	{
+		if (source_node_ids[lane] < 0 || source_node_ids[lane] >= node_count_)
+			return SSSP_ERROR_INVALID_SOURCE;
+	}
+
+	if (!prepareLayouts())
+		return SSSP_ERROR_OUT_OF_MEMORY;
+	CallerPin caller_pin(*this);
+	int num_threads = pool_.size();
+	hop_batch_size_ = count;
+	hop_stride_ = (count + HOP_LANE_WIDTH - 1) / HOP_LANE_WIDTH * HOP_LANE_WIDTH;
+	hop_distances_.assign((size_t)node_count_ * hop_stride_, SSSP_INFINITY);
+	hop_marked_.assign(node_count_, 0);
+	hop_candidates_.resize(num_threads);
+	hop_next_.resize(num_threads);
+	hop_improved_.resize(num_threads);
+
+	hop_frontier_.clear();
+	for (int lane = 0; lane < count; lane++)
+	{
+		int source = source_node_ids[lane];
+		hop_distances_[(size_t)source * hop_stride_ + lane] = 0;
+		if (find(hop_frontier_.begin(), hop_frontier_.end(), source) == hop_frontier_.end())
+			hop_frontier_.push_back(source);
+	}
+
+	rounds_ = 0;
+	while (!hop_frontier_.empty() && rounds_ < max_hops)
+	{
+		rounds_++;
+		int frontier_size = hop_frontier_.size();
+		int chunk = (frontier_size + num_threads - 1) / num_threads;
+
+		// claim the out-neighbours of the frontier and compute their next distances from
+		// the current ones, which stay unchanged until every thread is done
+		pool_.run([this, chunk, frontier_size](int tid)
+		{
+			int stride = hop_stride_;
+			const long *current = hop_distances_.data();
+			vector<int> &candidates = hop_candidates_[tid];
+			candidates.clear();
+
+			for (int i = tid * chunk; i < min(frontier_size, (tid + 1) * chunk); i++)
+			{
+				int u = hop_frontier_[i];
+				for (int e = csr_.offsets[u]; e < csr_.offsets[u + 1]; e++)
+				{
+					atomic_ref<char> marked(hop_marked_[csr_.neighbours[e]]);
+					if (!marked.load(memory_order_relaxed) && !marked.exchange(1, memory_order_relaxed))
+						candidates.push_back(csr_.neighbours[e]);
+				}
+			}
+
+			vector<long> &next = hop_next_[tid];
+			next.resize(candidates.size() * stride);
+			for (size_t i = 0; i < candidates.size(); i++)
+			{
+				int v = candidates[i];
+				// a local row the compiler knows is not aliased, so each block of lanes
+				// becomes a few vector instructions
+				long best[HOP_MAX_STRIDE];
+				copy(current + (size_t)v * stride, current + (size_t)(v + 1) * stride, best);
+				for (int e = csc_.offsets[v]; e < csc_.offsets[v + 1]; e++)
+				{
+					const long *source = current + (size_t)csc_.neighbours[e] * stride;
+					long weight = csc_.weights[e];
+					for (int block = 0; block < stride; block += HOP_LANE_WIDTH)
+					{
+						for (int lane = block; lane < block + HOP_LANE_WIDTH; lane++)
+						{
+							long candidate = source[lane] < SSSP_INFINITY ? source[lane] + weight : SSSP_INFINITY;
+							best[lane] = min(best[lane], candidate);
+						}
+					}
+				}
+				copy(best, best + stride, next.data() + i * stride);
+			}
+		});
+
+		// publish the candidates that improved in any lane, they form the next frontier
+		pool_.run([this](int tid)
+		{
+			int stride = hop_stride_;
+			long *current = hop_distances_.data();
+			const vector<int> &candidates = hop_candidates_[tid];
+			const long *next = hop_next_[tid].data();
+			vector<int> &improved = hop_improved_[tid];
+			improved.clear();
+
+			for (size_t i = 0; i < candidates.size(); i++)
+			{
+				int v = candidates[i];
+				hop_marked_[v] = 0;
+				long *row = current + (size_t)v * stride;
+				const long *best = next + i * stride;
+				if (!equal(best, best + stride, row))
+				{
+					copy(best, best + stride, row);
+					improved.push_back(v);
+				}
+			}
+		});
+
+		hop_frontier_.clear();
+		for (const vector<int> &improved : hop_improved_)
+			hop_frontier_.insert(hop_frontier_.end(), improved.begin(), improved.end());
+	}
+
+	return SSSP_OK;
+}
@@ -0,0 +1,217 @@
+#include "sssp_solver.h"
+#include "distance_atomics.h"
+#include <algorithm> // For min
+#include <chrono>	 // For timing the pre-pass
+
+using namespace std;
+
+/**
+ * @brief Reachability pre-pass of the pruned Bellman-Ford engine.
+ *
+ * Runs a parallel level-synchronous BFS over the CSR layout from every node with a
+ * finite distance (the source after solve(), the reached nodes after resume()). The
+ * reachable nodes are renumbered densely in id order, and the edges leaving them are
+ * copied from the CSR layout into a compact edge list over the new ids.
+ *
+ * The compaction is skipped when the reachable nodes own more than
+ * PRUNING_MAX_REACHABLE_SHARE of the edges, since the rounds would save less than the
+ * copy costs.
+ *
+ * @return true if the compact edge list and distances were built.
+ */
+bool Solver::pruneUnreachable()
+{
+	auto t1 = chrono::steady_clock::now();
+	if (!prepareCsr())
+		return false;
+
+	int num_threads = pool_.size();
+	int node_chunk = (node_count_ + num_threads - 1) / num_threads;
+	prune_ids_.resize(node_count_);
+	prune_next_.resize(num_threads);
+	vector<int> offsets(num_threads + 1, 0);
+
+	// seeds: every node already reached, -1 marks nodes the BFS has not visited
+	pool_.run([this, node_chunk](int tid)
+	{
+		int begin = min(node_count_, tid * node_chunk), end = min(node_count_, (tid + 1) * node_chunk);
+		prune_next_[tid].clear();
+		for (int v = begin; v < end; v++)
+		{
+			prune_ids_[v] = distances_[v] < SSSP_INFINITY ? 0 : -1;
+			if (prune_ids_[v] == 0)
+				prune_next_[tid].push_back(v);
+		}
+	});
+
+	prune_frontier_.clear();
+	while (true)
+	{
+		for (const vector<int> &next : prune_next_)
+			prune_frontier_.insert(prune_frontier_.end(), next.begin(), next.end());
+		if (prune_frontier_.empty())
+			break;
+
+		int frontier_size = prune_frontier_.size();
+		int frontier_chunk = (frontier_size + num_threads - 1) / num_threads;
+		pool_.run([this, frontier_size, frontier_chunk](int tid)
+		{
+			vector<int> &next = prune_next_[tid];
+			next.clear();
+			for (int i = tid * frontier_chunk; i < min(frontier_size, (tid + 1) * frontier_chunk); i++)
+			{
+				int u = prune_frontier_[i];
+				for (int j = csr_.offsets[u]; j < csr_.offsets[u + 1]; j++)
+				{
+					atomic_ref<int> id(prune_ids_[csr_.neighbours[j]]);
+					int unvisited = -1;
+					if (id.load(memory_order_relaxed) == -1 && id.compare_exchange_strong(unvisited, 0))
+						next.push_back(csr_.neighbours[j]);
+				}
+			}
+		});
+		prune_frontier_.clear();
+	}
+
+	// dense new ids in the order of the old ones, numbered per block of nodes, and the
+	// position of each block's outgoing edges in the compact list
+	vector<int> edge_offsets(num_threads + 1, 0);
+	pool_.run([this, node_chunk, &offsets, &edge_offsets](int tid)
+	{
+		int begin = min(node_count_, tid * node_chunk), end = min(node_count_, (tid + 1) * node_chunk);
+		int count = 0, out_edges = 0;
+		for (int v = begin; v < end; v++)
+		{
+			if (prune_ids_[v] == 0)
+			{
+				count++;
+				out_edges += csr_.offsets[v + 1] - csr_.offsets[v];
+			}
+		}
+		offsets[tid + 1] = count;
+		edge_offsets[tid + 1] = out_edges;
+	});
+	for (int tn = 0; tn < num_threads; tn++)
+	{
+		offsets[tn + 1] += offsets[tn];
+		edge_offsets[tn + 1] += edge_offsets[tn];
+	}
+	int reachable_nodes = offsets[num_threads];
+	int reachable_edges = edge_offsets[num_threads];
+
+	pruning_stats_.reachable_nodes = reachable_nodes;
+	pruning_stats_.reachable_edges = reachable_edges;
+	pruning_stats_.compacted = reachable_edges <= PRUNING_MAX_REACHABLE_SHARE * graph_->no_of_edges;
+	if (!pruning_stats_.compacted)
+	{
+		pruning_stats_.prepass_ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - t1).count();
+		return false;
+	}
+
+	if ((int)prune_distances_.size() < reachable_nodes)
+		prune_distances_.resize(reachable_nodes);
+	pool_.run([this, node_chunk, &offsets](int tid)
+	{
+		int begin = min(node_count_, tid * node_chunk), end = min(node_count_, (tid + 1) * node_chunk);
+		int next_id = offsets[tid];
+		for (int v = begin; v < end; v++)
+		{
+			if (prune_ids_[v] == 0)
+			{
+				prune_distances_[next_id] = distances_[v];
+				prune_ids_[v] = next_id++;
+			}
+		}
+	});
+
+	// edges leaving reachable nodes, over the new ids; the CSR keeps the sorted edge order
+	if ((int)prune_edges_.size() < reachable_edges)
+		prune_edges_.resize(reachable_edges);
+	pool_.run([this, node_chunk, &edge_offsets](int tid)
+	{
+		int begin = min(node_count_, tid * node_chunk), end = min(node_count_, (tid + 1) * node_chunk);
+		int next_edge = edge_offsets[tid];
+		for (int v = begin; v < end; v++)
+		{
+			if (prune_ids_[v] < 0)
+				continue;
+			for (int j = csr_.offsets[v]; j < csr_.offsets[v + 1]; j++)
+				prune_edges_[next_edge++] = {prune_ids_[v], prune_ids_[csr_.neighbours[j]], csr_.weights[j]};
+		}
+	});
+
+	pruning_stats_.prepass_ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - t1).count();
+	return true;
+}
+
+/**
+ * @brief Bellman-Ford rounds over the compact edge list built by pruneUnreachable().
+ *
+ * Edges whose source can never get a finite distance are not scanned at all, and the
+ * round limit shrinks to the number of reachable nodes. Distances are mapped back to the
+ * original ids at the end. pruningStats() reports the pre-pass time next to the edge
+ * scans it saved.
+ *
+ * @return SSSP_OK or SSSP_NEGATIVE_CYCLE.
+ */
+int Solver::solvePruned()
+{
+	int num_threads = pool_.size();
+	int node_chunk = (node_count_ + num_threads - 1) / num_threads;
+	int reachable_nodes = pruning_stats_.reachable_nodes;
+	int reachable_edges = pruning_stats_.reachable_edges;
+	int first_round = rounds_;
+
+	// the same rounds as relaxRound and hasNegativeCycle, on the compact list
+	int pruned_chunk = (reachable_edges + num_threads - 1) / num_threads;
+	auto relaxCompact = [this, reachable_edges, pruned_chunk](bool check_only)
+	{
+		pool_.run([this, reachable_edges, pruned_chunk, check_only](int tid)
+		{
+			long *node_distances = prune_distances_.data();
+			const Edge *edges = prune_edges_.data() + min(reachable_edges, tid * pruned_chunk);
+			int partition_size = min(reachable_edges, (tid + 1) * pruned_chunk) - min(reachable_edges, tid * pruned_chunk);
+			bool relaxed = false;
+
+			for (int j = 0; j < partition_size && !(check_only && relaxed); j++)
+			{
+				const Edge &edge = edges[j];
+				long source_distance = loadDistance(&node_distances[edge.source]);
+				if (source_distance >= SSSP_INFINITY)
+					continue;
+				if (check_only)
+					relaxed = source_distance + edge.weight < node_distances[edge.destination];
+				else if (atomicMinDistance(&node_distances[edge.destination], source_distance + edge.weight))
+					relaxed = true;
+			}
+
+			thread_flags_[tid].value = relaxed;
+		});
+
+		for (const ThreadFlag &flag : thread_flags_)
+		{
+			if (flag.value)
+				return true;
+		}
+		return false;
+	};
+
+	while (rounds_ < reachable_nodes - 1)
+	{
+		rounds_++;
+		if (!relaxCompact(false))
+			break;
+	}
+	bool negative_cycle = relaxCompact(true);
+
+	pool_.run([this, node_chunk](int tid)
+	{
+		int begin = min(node_count_, tid * node_chunk), end = min(node_count_, (tid + 1) * node_chunk);
+		for (int v = begin; v < end; v++)
+			distances_[v] = prune_ids_[v] >= 0 ? prune_distances_[prune_ids_[v]] : SSSP_INFINITY;
+	});
+
+	pruning_stats_.skipped_edge_scans = (long long)(graph_->no_of_edges - reachable_edges) * (rounds_ - first_round + 1);
+
+	return negative_cycle ? SSSP_NEGATIVE_CYCLE : SSSP_OK;
+}
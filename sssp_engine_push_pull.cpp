@@ -0,0 +1,247 @@
+#include "sssp_solver.h"
+#include "distance_atomics.h"
+#include <algorithm> // For fill and min
+#include <chrono>	 // For high resolution timing
+
+using namespace std;
+
+// Cost of pushing one edge relative to pulling one, used until both directions have been
+// timed on this machine. Pushing pays for atomics and scattered writes, like the alpha
+// parameter of direction-optimizing BFS.
+static const double DEFAULT_PUSH_TO_PULL_COST = 4.0;
+
+// weight of the newest measurement in the running per-edge costs
+static const double COST_SMOOTHING = 0.5;
+
+/**
+ * @brief Builds the CSR layout in the arena, once per graph.
+ *
+ * @return false if there was no memory for it.
+ */
+bool Solver::prepareCsr()
+{
+	return csr_.offsets != NULL || buildCsr(graph_, node_count_, &csr_, &arena_);
+}
+
+/**
+ * @brief Builds the CSC layout in the arena, once per graph.
+ *
+ * @return false if there was no memory for it.
+ */
+bool Solver::prepareCsc()
+{
+	return csc_.offsets != NULL || buildCsc(graph_, node_count_, &csc_, &arena_);
+}
+
+/**
+ * @brief Builds the CSR and CSC layouts and the frontier buffers in the arena, once per graph.
+ *
+ * @return false if there was no memory for them.
+ */
+bool Solver::prepareLayouts()
+{
+	if (layouts_ready_)
+		return true;
+
+	if (!prepareCsr() || !prepareCsc())
+		return false;
+	frontier_ = arena_.allocateArray<int>(node_count_);
+	if (frontier_ == NULL)
+		return false;
+	frontier_offsets_.resize(pool_.size() + 1);
+	layouts_ready_ = true;
+	return true;
+}
+
+/**
+ * @brief Turns the changed flags of the last round into the frontier list.
+ *
+ * Clears the flags for the next round.
+ *
+ * @param frontier_edges Set to the number of outgoing edges of the frontier.
+ * @return The number of nodes in the frontier.
+ */
+int Solver::collectFrontier(long long *frontier_edges)
+{
+	int num_threads = pool_.size();
+	int chunk = (node_count_ + num_threads - 1) / num_threads;
+
+	pool_.run([this, chunk](int tid)
+	{
+		int begin = min(node_count_, tid * chunk), end = min(node_count_, (tid + 1) * chunk);
+		long long count = 0, work = 0;
+		for (int v = begin; v < end; v++)
+		{
+			if (changed_[v])
+			{
+				count++;
+				work += csr_.offsets[v + 1] - csr_.offsets[v];
+			}
+		}
+		thread_flags_[tid].count = count;
+		thread_flags_[tid].work = work;
+	});
+
+	*frontier_edges = 0;
+	frontier_offsets_[0] = 0;
+	for (int tn = 0; tn < num_threads; tn++)
+	{
+		frontier_offsets_[tn + 1] = frontier_offsets_[tn] + (int)thread_flags_[tn].count;
+		*frontier_edges += thread_flags_[tn].work;
+	}
+
+	pool_.run([this, chunk](int tid)
+	{
+		int begin = min(node_count_, tid * chunk), end = min(node_count_, (tid + 1) * chunk);
+		int position = frontier_offsets_[tid];
+		for (int v = begin; v < end; v++)
+		{
+			if (changed_[v])
+			{
+				frontier_[position++] = v;
+				changed_[v] = 0;
+			}
+		}
+	});
+
+	return frontier_offsets_[num_threads];
+}
+
+/**
+ * @brief Push round: every frontier node relaxes its outgoing edges with an atomic min.
+ *
+ * Only the edges of nodes improved in the last round are touched, which is cheap while
+ * the frontier is small.
+ */
+void Solver::pushRound(int frontier_size)
+{
+	int num_threads = pool_.size();
+	int chunk = (frontier_size + num_threads - 1) / num_threads;
+
+	pool_.run([this, chunk, frontier_size](int tid)
+	{
+		long *node_distances = distances_;
+		int begin = min(frontier_size, tid * chunk), end = min(frontier_size, (tid + 1) * chunk);
+
+		for (int f = begin; f < end; f++)
+		{
+			int u = frontier_[f];
+			long source_distance = loadDistance(&node_distances[u]);
+
+			for (int e = csr_.offsets[u]; e < csr_.offsets[u + 1]; e++)
+			{
+				int v = csr_.neighbours[e];
+				if (atomicMinDistance(&node_distances[v], source_distance + csr_.weights[e]))
+					atomic_ref<char>(changed_[v]).store(1, memory_order_relaxed);
+			}
+		}
+	});
+}
+
+/**
+ * @brief Pull round: every node takes the minimum over its incoming edges.
+ *
+ * Each thread owns a range of destination nodes, so distances are written without
+ * atomics or write conflicts. This scans every edge and wins once the frontier is large.
+ */
+void Solver::pullRound()
+{
+	int num_threads = pool_.size();
+	int chunk = (node_count_ + num_threads - 1) / num_threads;
+
+	pool_.run([this, chunk](int tid)
+	{
+		long *node_distances = distances_;
+		int begin = min(node_count_, tid * chunk), end = min(node_count_, (tid + 1) * chunk);
+
+		for (int v = begin; v < end; v++)
+		{
+			long best = node_distances[v];
+			for (int e = csc_.offsets[v]; e < csc_.offsets[v + 1]; e++)
+			{
+				long source_distance = loadDistance(&node_distances[csc_.neighbours[e]]);
+				if (source_distance < SSSP_INFINITY && source_distance + csc_.weights[e] < best)
+					best = source_distance + csc_.weights[e];
+			}
+
+			if (best < node_distances[v])
+			{
+				atomic_ref<long>(node_distances[v]).store(best, memory_order_relaxed);
+				changed_[v] = 1;
+			}
+		}
+	});
+}
+
+/**
+ * @brief Direction-optimizing Bellman-Ford.
+ *
+ * Keeps the round structure of the Bellman-Ford engine, but each round only relaxes the
+ * edges of the nodes improved in the previous round. Every round it predicts the cost of
+ * pushing the frontier's outgoing edges and of pulling all incoming edges from the
+ * per-edge costs measured in earlier rounds, and runs the cheaper direction. The costs
+ * are kept across solves, so the switching threshold adapts to the machine and graph.
+ *
+ * Starts from the state set up by solve() or resume(): the nodes flagged in changed_
+ * form the first frontier.
+ *
+ * @return SSSP_OK or SSSP_NEGATIVE_CYCLE.
+ */
+int Solver::solvePushPull()
+{
+	if (!prepareLayouts())
+		return SSSP_ERROR_OUT_OF_MEMORY;
+
+	long long frontier_edges;
+	int frontier_size = collectFrontier(&frontier_edges);
+	long long no_of_edges = graph_->no_of_edges;
+
+	pull_rounds_ = 0;
+	while (frontier_size > 0 && rounds_ < node_count_ - 1)
+	{
+		rounds_++;
+
+		// relative costs until both directions were measured
+		double push_cost = push_ns_per_edge_, pull_cost = pull_ns_per_edge_;
+		if (push_cost == 0 && pull_cost == 0)
+		{
+			push_cost = DEFAULT_PUSH_TO_PULL_COST;
+			pull_cost = 1;
+		}
+		else if (push_cost == 0)
+			push_cost = pull_cost * DEFAULT_PUSH_TO_PULL_COST;
+		else if (pull_cost == 0)
+			pull_cost = push_cost / DEFAULT_PUSH_TO_PULL_COST;
+
+		bool pull = frontier_edges * push_cost > no_of_edges * pull_cost;
+
+		auto t1 = chrono::high_resolution_clock::now();
+		if (pull)
+			pullRound();
+		else
+			pushRound(frontier_size);
+		auto t2 = chrono::high_resolution_clock::now();
+
+		double nanoseconds = (double)chrono::duration_cast<chrono::nanoseconds>(t2 - t1).count();
+		if (pull)
+		{
+			pull_rounds_++;
+			double measured = nanoseconds / max(1LL, no_of_edges);
+			pull_ns_per_edge_ = pull_ns_per_edge_ == 0 ? measured : (1 - COST_SMOOTHING) * pull_ns_per_edge_ + COST_SMOOTHING * measured;
+		}
+		else if (frontier_edges > 0)
+		{
+			double measured = nanoseconds / frontier_edges;
+			push_ns_per_edge_ = push_ns_per_edge_ == 0 ? measured : (1 - COST_SMOOTHING) * push_ns_per_edge_ + COST_SMOOTHING * measured;
+		}
+
+		// the changed flags are the active set until collectFrontier consumes them
+		checkpointRound();
+		frontier_size = collectFrontier(&frontier_edges);
+	}
+
+	// nodes still improving after no_of_nodes - 1 rounds lie on or behind a negative cycle
+	if (frontier_size > 0)
+		return hasNegativeCycle() ? SSSP_NEGATIVE_CYCLE : SSSP_OK;
+	return SSSP_OK;
+}
@@ -0,0 +1,212 @@
+#include "sssp_solver.h"
+#include "distance_atomics.h"
+#include <algorithm> // For fill, max and min
+#include <atomic>	 // For handing out components to threads
+
+using namespace std;
+
+/**
+ * @brief Decomposes the graph into strongly connected components, once per graph.
+ */
+bool Solver::prepareScc()
+{
+	if (scc_ready_)
+		return true;
+
+	if (!prepareLayouts())
+		return false;
+	decomposeScc(graph_, csr_, csc_, pool_, &scc_);
+	scc_ready_ = true;
+	return true;
+}
+
+/**
+ * @brief Bellman-Ford rounds inside one component on the calling thread, followed by one
+ * relaxation of the edges leaving it.
+ *
+ * A component none of whose nodes has a finite distance is skipped, since every edge into
+ * it has been relaxed already. Shortest paths inside a component of k nodes have at most
+ * k - 1 edges, so a component still changing after k - 1 rounds holds a negative cycle.
+ *
+ * @return The number of rounds run inside the component.
+ */
+static int solveComponent(const SccDecomposition &scc, int c, long *distances, bool *negative_cycle)
+{
+	bool reached = false;
+	for (int i = scc.node_begin[c]; i < scc.node_begin[c + 1] && !reached; i++)
+		reached = distances[scc.nodes[i]] < SSSP_INFINITY;
+	if (!reached)
+		return 0;
+
+	const Edge *edges = scc.internal_edges.data() + scc.internal_begin[c];
+	int no_of_edges = scc.internal_begin[c + 1] - scc.internal_begin[c];
+	int size = scc.node_begin[c + 1] - scc.node_begin[c];
+	int rounds = 0;
+	bool changed = true;
+	while (changed && rounds < size - 1)
+	{
+		rounds++;
+		changed = false;
+		for (int j = 0; j < no_of_edges; j++)
+		{
+			const Edge &edge = edges[j];
+			long source_distance = distances[edge.source];
+			if (source_distance < SSSP_INFINITY && source_distance + edge.weight < distances[edge.destination])
+			{
+				distances[edge.destination] = source_distance + edge.weight;
+				changed = true;
+			}
+		}
+	}
+
+	for (int j = 0; changed && j < no_of_edges; j++)
+	{
+		const Edge &edge = edges[j];
+		if (distances[edge.source] < SSSP_INFINITY &&
+			distances[edge.source] + edge.weight < distances[edge.destination])
+		{
+			*negative_cycle = true;
+			break;
+		}
+	}
+
+	// other components of the same level may update the same successors
+	for (int j = scc.cross_begin[c]; j < scc.cross_begin[c + 1]; j++)
+	{
+		const Edge &edge = scc.cross_edges[j];
+		if (distances[edge.source] < SSSP_INFINITY)
+			atomicMinDistance(&distances[edge.destination], distances[edge.source] + edge.weight);
+	}
+
+	return rounds;
+}
+
+/**
+ * @brief Solves strongly connected components in topological order.
+ *
+ * Distances can only flow along the condensation DAG, so a component is final once it
+ * has converged on the distances that entered it. The components are processed level by
+ * level (see SccDecomposition): Bellman-Ford rounds run only inside a component, and the
+ * edges leaving it are relaxed exactly once afterwards. The components of a level are
+ * independent; small ones are handed out to the threads one component at a time, while
+ * a component with at least SCC_PARALLEL_MIN_EDGES internal edges is relaxed by all
+ * threads together, round by round like the bellman-ford engine. Acyclic regions thus
+ * cost one pass over their edges and rounds are only spent where cycles are.
+ *
+ * rounds() reports the most rounds any one component needed, which is what bounds the
+ * work per edge; components that are single nodes without a self-loop need none.
+ *
+ * @return SSSP_OK or SSSP_NEGATIVE_CYCLE.
+ */
+int Solver::solveScc()
+{
+	if (!prepareScc())
+		return SSSP_ERROR_OUT_OF_MEMORY;
+
+	int num_threads = pool_.size();
+	bool negative_cycle = false;
+	int most_rounds = 0;
+	vector<int> small_components;
+
+	// one parallel pass over an edge range: relax, or only look for a relaxable edge
+	auto relaxParallel = [this, num_threads](const Edge *edges, int no_of_edges, bool check_only)
+	{
+		int chunk = (no_of_edges + num_threads - 1) / num_threads;
+		pool_.run([this, edges, no_of_edges, chunk, check_only](int tid)
+		{
+			long *node_distances = distances_;
+			bool relaxed = false;
+			for (int j = tid * chunk; j < min(no_of_edges, (tid + 1) * chunk) && !(check_only && relaxed); j++)
+			{
+				const Edge &edge = edges[j];
+				long source_distance = loadDistance(&node_distances[edge.source]);
+				if (source_distance >= SSSP_INFINITY)
+					continue;
+				if (check_only)
+					relaxed = source_distance + edge.weight < loadDistance(&node_distances[edge.destination]);
+				else if (atomicMinDistance(&node_distances[edge.destination], source_distance + edge.weight))
+					relaxed = true;
+			}
+			thread_flags_[tid].value = relaxed;
+		});
+
+		for (const ThreadFlag &flag : thread_flags_)
+		{
+			if (flag.value)
+				return true;
+		}
+		return false;
+	};
+
+	for (int level = 0; level < scc_.no_of_levels && !negative_cycle; level++)
+	{
+		int level_rounds = 0;
+		long long small_edges = 0;
+		small_components.clear();
+
+		for (int c = scc_.level_begin[level]; c < scc_.level_begin[level + 1]; c++)
+		{
+			int internal = scc_.internal_begin[c + 1] - scc_.internal_begin[c];
+			if (internal < SCC_PARALLEL_MIN_EDGES || num_threads == 1)
+			{
+				small_components.push_back(c);
+				small_edges += internal + scc_.cross_begin[c + 1] - scc_.cross_begin[c];
+				continue;
+			}
+
+			// a large component, relaxed by all threads
+			bool reached = false;
+			for (int i = scc_.node_begin[c]; i < scc_.node_begin[c + 1] && !reached; i++)
+				reached = distances_[scc_.nodes[i]] < SSSP_INFINITY;
+			if (!reached)
+				continue;
+
+			const Edge *edges = scc_.internal_edges.data() + scc_.internal_begin[c];
+			int size = scc_.node_begin[c + 1] - scc_.node_begin[c];
+			int rounds = 0;
+			bool changed = true;
+			while (changed && rounds < size - 1)
+			{
+				rounds++;
+				changed = relaxParallel(edges, internal, false);
+			}
+			if (changed && relaxParallel(edges, internal, true))
+				negative_cycle = true;
+			relaxParallel(scc_.cross_edges.data() + scc_.cross_begin[c], scc_.cross_begin[c + 1] - scc_.cross_begin[c],
+						  false);
+			level_rounds = max(level_rounds, rounds);
+		}
+
+		// levels with little work are not worth waking the pool for
+		int no_of_small = small_components.size();
+		if (small_edges < SCC_PARALLEL_MIN_EDGES || num_threads == 1)
+		{
+			for (int c : small_components)
+				level_rounds = max(level_rounds, solveComponent(scc_, c, distances_, &negative_cycle));
+		}
+		else
+		{
+			atomic<int> next(0);
+			pool_.run([this, &small_components, no_of_small, &next](int tid)
+			{
+				bool found = false;
+				long long rounds = 0;
+				for (int i = next.fetch_add(1); i < no_of_small; i = next.fetch_add(1))
+					rounds = max(rounds, (long long)solveComponent(scc_, small_components[i], distances_, &found));
+				thread_flags_[tid].value = found;
+				thread_flags_[tid].work = rounds;
+			});
+			for (const ThreadFlag &flag : thread_flags_)
+			{
+				negative_cycle = negative_cycle || flag.value;
+				level_rounds = max(level_rounds, (int)flag.work);
+			}
+		}
+
+		most_rounds = max(most_rounds, level_rounds);
+	}
+
+	fill(changed_, changed_ + node_count_, 0);
+	rounds_ = most_rounds;
+	return negative_cycle ? SSSP_NEGATIVE_CYCLE : SSSP_OK;
+}
@@ -0,0 +1,103 @@
+#include "sssp_solver.h"
+#include <algorithm> // For fill, min and swap
+
+using namespace std;
+
+/**
+ * @brief Builds the SELL-C-sigma layout, its two distance vectors and the per-thread
+ * chunk ranges in the arena, once per graph.
+ *
+ * Only the CSC it is converted from is built, not the CSR and frontier of push/pull.
+ */
+bool Solver::prepareSell()
+{
+	if (sell_ready_)
+		return true;
+
+	if (!prepareCsc() || !buildSell(csc_, &sell_, &arena_))
+		return false;
+	spmv_distances_[0] = arena_.allocateArray<long>(max(sell_.no_of_rows, 1));
+	spmv_distances_[1] = arena_.allocateArray<long>(max(sell_.no_of_rows, 1));
+	if (spmv_distances_[0] == NULL || spmv_distances_[1] == NULL)
+		return false;
+
+	// chunk ranges of about equal cost, counting every row as one entry
+	int num_threads = pool_.size();
+	long long total_cost = sell_.no_of_entries + sell_.no_of_rows;
+	spmv_partition_.assign(num_threads + 1, sell_.no_of_chunks);
+	spmv_partition_[0] = 0;
+	int tn = 1;
+	for (int k = 0; k < sell_.no_of_chunks && tn < num_threads; k++)
+	{
+		long long cost = sell_.chunk_offsets[k] + (long long)k * SELL_CHUNK_HEIGHT;
+		while (tn < num_threads && cost >= total_cost * tn / num_threads)
+			spmv_partition_[tn++] = k;
+	}
+	sell_ready_ = true;
+	return true;
+}
+
+/**
+ * @brief Bellman-Ford as repeated min-plus sparse matrix-vector products.
+ *
+ * Every round computes, for every node v at once, the minimum of its distance and of
+ * d(u) + w(u, v) over its incoming edges, pulling over the SELL-C-sigma layout (see
+ * SellGraph) with one vector lane per node. The rounds read the distances of the last
+ * round and write a second vector, so no lane ever conflicts with another and no atomics
+ * are needed. Rows are sorted by in-degree within small windows, so the lanes of a chunk
+ * need about the same number of steps and little padding is stored. The kernel uses
+ * AVX-512 or AVX2 gathers, NEON, or plain C++, whichever the build targets (see
+ * sellKernelBackend).
+ *
+ * @return SSSP_OK or SSSP_NEGATIVE_CYCLE.
+ */
+int Solver::solveSpmv()
+{
+	if (!prepareSell())
+		return SSSP_ERROR_OUT_OF_MEMORY;
+
+	int num_threads = pool_.size();
+	int row_chunk = (sell_.no_of_rows + num_threads - 1) / num_threads;
+	long *current = spmv_distances_[0];
+	long *next = spmv_distances_[1];
+
+	pool_.run([this, row_chunk, current](int tid)
+	{
+		for (int r = tid * row_chunk; r < min(sell_.no_of_rows, (tid + 1) * row_chunk); r++)
+			current[r] = sell_.node_of_row[r] >= 0 ? distances_[sell_.node_of_row[r]] : SSSP_INFINITY;
+	});
+
+	auto multiply = [this, &current, &next]()
+	{
+		pool_.run([this, current, next](int tid)
+		{
+			thread_flags_[tid].value = sellRelaxChunks(sell_, current, next, spmv_partition_[tid], spmv_partition_[tid + 1]);
+		});
+		swap(current, next);
+
+		for (const ThreadFlag &flag : thread_flags_)
+		{
+			if (flag.value)
+				return true;
+		}
+		return false;
+	};
+
+	bool changed = true;
+	while (changed && rounds_ < node_count_ - 1)
+	{
+		rounds_++;
+		changed = multiply();
+	}
+	bool negative_cycle = changed && multiply();
+
+	int node_chunk = (node_count_ + num_threads - 1) / num_threads;
+	pool_.run([this, node_chunk, current](int tid)
+	{
+		for (int v = tid * node_chunk; v < min(node_count_, (tid + 1) * node_chunk); v++)
+			distances_[v] = current[sell_.row_of_node[v]];
+	});
+
+	fill(changed_, changed_ + node_count_, 0);
+	return negative_cycle ? SSSP_NEGATIVE_CYCLE : SSSP_OK;
+}
@@ -0,0 +1,128 @@
+#include "sssp_solver.h"
+#include <algorithm> // For fill and swap
+
+using namespace std;
+
+/**
+ * @brief Label-correcting FIFO solve with Tarjan's subtree disassembly.
+ *
+ * Bellman-Ford-Moore over the CSR layout that keeps the shortest path tree explicitly,
+ * as a preorder list of the tree nodes (tarjan_next_, tarjan_prev_) with their depths.
+ * When u lowers the distance of v, everything below v in the tree was labelled from
+ * v's old distance and will be improved again through v, so the subtree is taken out
+ * of the tree and its queued nodes are dropped instead of being scanned with stale
+ * labels. If u itself is found in that subtree, the new edge (u, v) closes a cycle in
+ * the tree, which is a negative cycle, and the solve stops right there instead of
+ * running no_of_nodes - 1 rounds first.
+ *
+ * The queue is processed in passes, each scanning the nodes queued during the previous
+ * one; rounds_ counts the passes. Nodes flagged in changed_ start as roots, so resumed
+ * solves work as well. As in Bellman-Ford, a pass beyond no_of_nodes also reports a
+ * negative cycle.
+ *
+ * @return SSSP_OK or SSSP_NEGATIVE_CYCLE.
+ */
+int Solver::solveTarjan()
+{
+	if (!prepareCsr())
+		return SSSP_ERROR_OUT_OF_MEMORY;
+
+	// node node_count_ is the sentinel of the preorder list, the roots hang below it
+	int root = node_count_;
+	tarjan_next_.resize(node_count_ + 1);
+	tarjan_prev_.resize(node_count_ + 1);
+	tarjan_depth_.assign(node_count_ + 1, -1);
+	tarjan_queued_.assign(node_count_, 0);
+	tarjan_pass_[0].clear();
+	tarjan_pass_[1].clear();
+
+	int *next = tarjan_next_.data();
+	int *prev = tarjan_prev_.data();
+	int *depth = tarjan_depth_.data();
+	char *queued = tarjan_queued_.data();
+	long *node_distances = distances_;
+	auto insertAfter = [next, prev](int v, int u)
+	{
+		next[v] = next[u];
+		prev[next[u]] = v;
+		next[u] = v;
+		prev[v] = u;
+	};
+
+	next[root] = prev[root] = root;
+	for (int v = 0; v < node_count_; v++)
+	{
+		if (changed_[v] && node_distances[v] < SSSP_INFINITY)
+		{
+			insertAfter(v, root);
+			depth[v] = 0;
+			queued[v] = 1;
+			tarjan_pass_[0].push_back(v);
+		}
+	}
+
+	bool negative_cycle = false;
+	while (!tarjan_pass_[0].empty() && !negative_cycle)
+	{
+		if (++rounds_ > node_count_)
+		{
+			negative_cycle = true;
+			break;
+		}
+
+		for (int u : tarjan_pass_[0])
+		{
+			// taken out of the tree since it was queued, or already scanned this pass
+			if (!queued[u])
+				continue;
+			queued[u] = 0;
+
+			long source_distance = node_distances[u];
+			for (int e = csr_.offsets[u]; e < csr_.offsets[u + 1] && !negative_cycle; e++)
+			{
+				int v = csr_.neighbours[e];
+				long candidate = source_distance + csr_.weights[e];
+				if (candidate >= node_distances[v])
+					continue;
+
+				if (depth[v] >= 0)
+				{
+					// the subtree of v is the run of deeper nodes following it in preorder
+					bool closes_cycle = v == u;
+					int x = next[v];
+					while (!closes_cycle && depth[x] > depth[v])
+					{
+						closes_cycle = x == u;
+						depth[x] = -1;
+						queued[x] = 0;
+						x = next[x];
+					}
+					if (closes_cycle)
+					{
+						negative_cycle = true;
+						break;
+					}
+					next[prev[v]] = x;
+					prev[x] = prev[v];
+				}
+
+				node_distances[v] = candidate;
+				depth[v] = depth[u] + 1;
+				insertAfter(v, u);
+				if (!queued[v])
+				{
+					queued[v] = 1;
+					tarjan_pass_[1].push_back(v);
+				}
+			}
+			if (negative_cycle)
+				break;
+		}
+
+		swap(tarjan_pass_[0], tarjan_pass_[1]);
+		tarjan_pass_[1].clear();
+	}
+
+	fill(changed_, changed_ + node_count_, 0);
+	return negative_cycle ? SSSP_NEGATIVE_CYCLE : SSSP_OK;
+}
@@ -0,0 +1,446 @@
+#include "sssp_server.h"
+#include <iostream>		// For input/output stream
+#include <sstream>		// For parsing commands
+#include <vector>		// For vector data structure
+#include <algorithm>	// For find and max
+#include <cstring>		// For strncpy
+#include <ctime>		// For clock_gettime
+#include <unistd.h>		// For read, close and unlink
+#include <sys/socket.h> // For sockets
+#include <sys/un.h>		// For Unix domain socket addresses
+
+using namespace std;
+
+static long long monotonicMicroseconds()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000000LL + now.tv_nsec / 1000;
+}
+
+SsspServer::Connection::Connection(int fd) : fd(fd)
+{
+	pthread_mutex_init(&write_mutex, NULL);
+}
+
+SsspServer::Connection::~Connection()
+{
+	close(fd);
+	pthread_mutex_destroy(&write_mutex);
+}
+
+/**
+ * @brief Writes a whole reply, serialised with the other writers of this connection.
+ *
+ * Errors are ignored: a client that went away simply stops receiving answers.
+ */
+void SsspServer::Connection::send(const string &reply)
+{
+	pthread_mutex_lock(&write_mutex);
+	size_t sent = 0;
+	while (sent < reply.size())
+	{
+		ssize_t n = ::send(fd, reply.data() + sent, reply.size() - sent, MSG_NOSIGNAL);
+		if (n <= 0)
+			break;
+		sent += n;
+	}
+	pthread_mutex_unlock(&write_mutex);
+}
+
+SsspServer::SsspServer(Solver *solver, ServerOptions options)
+	: solver_(solver), options_(options), listen_fd_(-1), stopping_(false)
+{
+	options_.max_batch = max(1, min(options_.max_batch, SOLVER_MAX_BATCH));
+	stats_ = ServerStats();
+	if (options_.cache_budget_bytes > 0)
+		cache_.reset(new ResultCache(options_.cache_budget_bytes));
+
+	pthread_condattr_t attr;
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&request_ready_, &attr);
+	pthread_condattr_destroy(&attr);
+	pthread_mutex_init(&mutex_, NULL);
+}
+
+SsspServer::~SsspServer()
+{
+	pthread_cond_destroy(&request_ready_);
+	pthread_mutex_destroy(&mutex_);
+}
+
+/**
+ * @brief Listens on the socket and serves clients until stop() is called.
+ *
+ * Every connection gets its own reader thread, a single batcher thread owns the solver.
+ * All of them are joined before run() returns, so none outlives the server.
+ *
+ * @return 0 after a clean shutdown, -1 if the socket could not be set up.
+ */
+int SsspServer::run()
+{
+	listen_fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listen_fd_ < 0)
+	{
+		perror("socket");
+		return -1;
+	}
+
+	struct sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strncpy(address.sun_path, options_.socket_path.c_str(), sizeof(address.sun_path) - 1);
+	unlink(options_.socket_path.c_str());
+
+	if (bind(listen_fd_, (struct sockaddr *)&address, sizeof(address)) < 0 || listen(listen_fd_, 128) < 0)
+	{
+		perror("bind/listen");
+		close(listen_fd_);
+		return -1;
+	}
+
+	pthread_create(&batcher_, NULL, batcherMain, this);
+
+	while (true)
+	{
+		int fd = accept(listen_fd_, NULL, NULL);
+		if (fd < 0)
+		{
+			pthread_mutex_lock(&mutex_);
+			bool stopping = stopping_;
+			pthread_mutex_unlock(&mutex_);
+			if (stopping)
+				break;
+			continue;
+		}
+
+		// readers of clients that have disconnected are joined as new ones arrive
+		joinReaders(false);
+
+		pthread_mutex_lock(&mutex_);
+		readers_.push_back(Reader{pthread_t(), make_shared<Connection>(fd), false});
+		ReaderArg *reader = new ReaderArg{this, &readers_.back()};
+		if (pthread_create(&readers_.back().thread, NULL, readerMain, reader) != 0)
+		{
+			delete reader;
+			readers_.pop_back();
+		}
+		pthread_mutex_unlock(&mutex_);
+	}
+
+	pthread_join(batcher_, NULL);
+	joinReaders(true);
+	close(listen_fd_);
+	unlink(options_.socket_path.c_str());
+
+	return 0;
+}
+
+/**
+ * @brief Makes run() return. Queries still queued are dropped and every client is
+ * disconnected.
+ */
+void SsspServer::stop()
+{
+	pthread_mutex_lock(&mutex_);
+	stopping_ = true;
+	pthread_cond_broadcast(&request_ready_);
+	for (Reader &reader : readers_)
+	{
+		if (reader.connection)
+			shutdown(reader.connection->fd, SHUT_RDWR);
+	}
+	pthread_mutex_unlock(&mutex_);
+
+	shutdown(listen_fd_, SHUT_RDWR);
+}
+
+ServerStats SsspServer::stats()
+{
+	pthread_mutex_lock(&mutex_);
+	ServerStats current = stats_;
+	current.queue_depth = queue_.size();
+	pthread_mutex_unlock(&mutex_);
+	return current;
+}
+
+string SsspServer::formatStats()
+{
+	ServerStats current = stats();
+	ostringstream reply;
+	reply << "queue_depth " << current.queue_depth
+		  << " requests " << current.requests
+		  << " batches " << current.batches
+		  << " mean_batch_size " << (current.batches ? (double)current.batched_sources / current.batches : 0.0)
+		  << " mean_latency_us " << (current.requests ? current.total_latency_us / current.requests : 0)
+		  << " max_latency_us " << current.max_latency_us;
+	if (cache_)
+	{
+		CacheStats cache = cache_->stats();
+		reply << " cached_requests " << current.cached_requests
+			  << " cache_hits " << cache.hits
+			  << " cache_misses " << cache.misses
+			  << " cache_evictions " << cache.evictions
+			  << " cache_entries " << cache.entries
+			  << " cache_bytes " << cache.bytes_used
+			  << " cache_raw_bytes " << cache.raw_bytes;
+	}
+	reply << "\n";
+	return reply.str();
+}
+
+void *SsspServer::readerMain(void *arg)
+{
+	ReaderArg *reader = (ReaderArg *)arg;
+	SsspServer *server = reader->server;
+	server->readConnection(reader->reader->connection);
+
+	// the socket closes once the batcher has answered the last queued request of the client
+	pthread_mutex_lock(&server->mutex_);
+	reader->reader->finished = true;
+	reader->reader->connection.reset();
+	pthread_mutex_unlock(&server->mutex_);
+	delete reader;
+	return NULL;
+}
+
+/**
+ * @brief Joins the reader threads that have finished, or all of them after shutting
+ * down their connections.
+ *
+ * The threads are joined without holding the mutex, which they take on their way out.
+ */
+void SsspServer::joinReaders(bool all)
+{
+	list<Reader> done;
+	pthread_mutex_lock(&mutex_);
+	for (auto it = readers_.begin(); it != readers_.end();)
+	{
+		auto next = std::next(it);
+		if (all && it->connection)
+			shutdown(it->connection->fd, SHUT_RDWR);
+		if (all || it->finished)
+			done.splice(done.end(), readers_, it);
+		it = next;
+	}
+	pthread_mutex_unlock(&mutex_);
+
+	for (Reader &reader : done)
+		pthread_join(reader.thread, NULL);
+}
+
+void *SsspServer::batcherMain(void *arg)
+{
+	((SsspServer *)arg)->batchLoop();
+	return NULL;
+}
+
+/**
+ * @brief Parses the commands of one client until it disconnects.
+ *
+ * A client that sends more than SERVER_MAX_LINE bytes without a newline is disconnected,
+ * so no connection can make the server buffer without bound.
+ */
+void SsspServer::readConnection(shared_ptr<Connection> connection)
+{
+	string pending;
+	char buffer[4096];
+
+	while (true)
+	{
+		ssize_t n = read(connection->fd, buffer, sizeof(buffer));
+		if (n <= 0)
+			break;
+		pending.append(buffer, n);
+
+		size_t end;
+		while ((end = pending.find('\n')) != string::npos)
+		{
+			istringstream line(pending.substr(0, end));
+			pending.erase(0, end + 1);
+
+			string command;
+			line >> command;
+			if (command == "QUERY")
+			{
+				Request request;
+				if (!(line >> request.source >> request.target))
+				{
+					connection->send("ERROR usage: QUERY <source> <target>\n");
+					continue;
+				}
+				request.connection = connection;
+				request.enqueue_time_us = monotonicMicroseconds();
+
+				// hot sources are answered without waiting for a batch
+				long distance;
+				if (cache_ && cache_->lookupDistance(request.source, request.target, solver_->graphVersion(), &distance))
+				{
+					ostringstream reply;
+					reply << request.source << " " << request.target << " ";
+					if (distance >= SSSP_INFINITY)
+						reply << "INF\n";
+					else
+						reply << distance << "\n";
+					connection->send(reply.str());
+
+					long long latency_us = monotonicMicroseconds() - request.enqueue_time_us;
+					pthread_mutex_lock(&mutex_);
+					stats_.requests++;
+					stats_.cached_requests++;
+					stats_.total_latency_us += latency_us;
+					stats_.max_latency_us = max(stats_.max_latency_us, latency_us);
+					pthread_mutex_unlock(&mutex_);
+					continue;
+				}
+
+				pthread_mutex_lock(&mutex_);
+				queue_.push_back(request);
+				pthread_cond_signal(&request_ready_);
+				pthread_mutex_unlock(&mutex_);
+			}
+			else if (command == "STATS")
+			{
+				connection->send(formatStats());
+			}
+			else if (!command.empty())
+			{
+				connection->send("ERROR unknown command " + command + "\n");
+			}
+		}
+
+		if (pending.size() > SERVER_MAX_LINE)
+		{
+			connection->send("ERROR line too long\n");
+			shutdown(connection->fd, SHUT_RDWR);
+			break;
+		}
+	}
+}
+
+/**
+ * @brief Forms batches from the queue and answers them, one sweep at a time.
+ *
+ * A batch is closed when the oldest queued request has waited batch_window_us or when
+ * max_batch distinct sources are queued. Requests whose source does not fit into the
+ * batch stay queued, in order, for the next one.
+ */
+void SsspServer::batchLoop()
+{
+	pthread_mutex_lock(&mutex_);
+
+	while (true)
+	{
+		while (queue_.empty() && !stopping_)
+			pthread_cond_wait(&request_ready_, &mutex_);
+		if (stopping_)
+			break;
+
+		long long deadline_us = queue_.front().enqueue_time_us + options_.batch_window_us;
+		while (!stopping_)
+		{
+			vector<int> sources;
+			for (size_t i = 0; i < queue_.size() && (int)sources.size() < options_.max_batch; i++)
+			{
+				if (find(sources.begin(), sources.end(), queue_[i].source) == sources.end())
+					sources.push_back(queue_[i].source);
+			}
+			long long now_us = monotonicMicroseconds();
+			if ((int)sources.size() >= options_.max_batch || now_us >= deadline_us)
+				break;
+
+			struct timespec deadline;
+			deadline.tv_sec = deadline_us / 1000000;
+			deadline.tv_nsec = (deadline_us % 1000000) * 1000;
+			pthread_cond_timedwait(&request_ready_, &mutex_, &deadline);
+		}
+		if (stopping_)
+			break;
+
+		deque<Request> batch, remaining;
+		vector<int> sources;
+		for (Request &request : queue_)
+		{
+			bool known = find(sources.begin(), sources.end(), request.source) != sources.end();
+			if (!known && (int)sources.size() < options_.max_batch)
+			{
+				sources.push_back(request.source);
+				known = true;
+			}
+			if (known)
+				batch.push_back(request);
+			else
+				remaining.push_back(request);
+		}
+		queue_.swap(remaining);
+
+		pthread_mutex_unlock(&mutex_);
+		answerBatch(batch);
+		pthread_mutex_lock(&mutex_);
+	}
+
+	pthread_mutex_unlock(&mutex_);
+}
+
+/**
+ * @brief Solves all distinct sources of a batch in one sweep and replies to every request.
+ */
+void SsspServer::answerBatch(deque<Request> &batch)
+{
+	int node_count = solver_->nodeCount();
+	vector<int> sources;
+	for (Request &request : batch)
+	{
+		if (request.source >= 0 && request.source < node_count &&
+			find(sources.begin(), sources.end(), request.source) == sources.end())
+			sources.push_back(request.source);
+	}
+
+	if (!sources.empty())
+		solver_->solveBatch(sources.data(), (int)sources.size());
+
+	if (cache_)
+	{
+		for (int lane = 0; lane < (int)sources.size(); lane++)
+		{
+			if (!solver_->batchNegativeCycle(lane))
+				cache_->insert(sources[lane], solver_->graphVersion(), solver_->batchDistances() + lane,
+							   node_count, solver_->batchSize());
+		}
+	}
+
+	long long done_us = monotonicMicroseconds();
+	long long total_latency_us = 0, max_latency_us = 0;
+
+	for (Request &request : batch)
+	{
+		ostringstream reply;
+		reply << request.source << " " << request.target << " ";
+
+		int lane = (int)(find(sources.begin(), sources.end(), request.source) - sources.begin());
+		if (lane == (int)sources.size() || request.target < 0 || request.target >= node_count)
+			reply << "ERROR invalid node";
+		else if (solver_->batchNegativeCycle(lane))
+			reply << "NEGATIVE_CYCLE";
+		else if (solver_->batchDistance(lane, request.target) >= SSSP_INFINITY)
+			reply << "INF";
+		else
+			reply << solver_->batchDistance(lane, request.target);
+		reply << "\n";
+
+		request.connection->send(reply.str());
+
+		long long latency_us = done_us - request.enqueue_time_us;
+		total_latency_us += latency_us;
+		max_latency_us = max(max_latency_us, latency_us);
+	}
+
+	pthread_mutex_lock(&mutex_);
+	stats_.requests += batch.size();
+	stats_.batches++;
+	stats_.batched_sources += sources.size();
+	stats_.total_latency_us += total_latency_us;
+	stats_.max_latency_us = max(stats_.max_latency_us, max_latency_us);
+	pthread_mutex_unlock(&mutex_);
+}
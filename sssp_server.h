@@ -0,0 +1,115 @@
+#ifndef SSSP_SERVER_H
+#define SSSP_SERVER_H
+
+#include <pthread.h>
+#include <deque>
+#include <list>
+#include <memory>
+#include <string>
+#include "sssp_solver.h"
+#include "result_cache.h"
+
+// longest command line a client may send, a connection that exceeds it is dropped
+const size_t SERVER_MAX_LINE = 1024;
+
+struct ServerOptions
+{
+	// path of the Unix domain socket the server listens on
+	std::string socket_path;
+	// how long the first request of a batch waits for more requests to join it
+	int batch_window_us;
+	// most distinct sources per sweep, at most SOLVER_MAX_BATCH
+	int max_batch;
+	// memory budget of the result cache, 0 disables it
+	size_t cache_budget_bytes;
+};
+
+// counters exposed through the STATS command
+struct ServerStats
+{
+	long long queue_depth;
+	long long requests;
+	long long batches;
+	long long batched_sources;
+	long long total_latency_us;
+	long long max_latency_us;
+	// queries answered from the result cache without queueing
+	long long cached_requests;
+};
+
+// Local query server.
+//
+// Clients connect to a Unix domain socket and send newline terminated commands:
+//   QUERY <source> <target>  answered with "<source> <target> <distance>" once solved
+//   STATS                    answered immediately with the ServerStats counters
+// Every connection may pipeline many queries. Queries that arrive within the batch
+// window are answered by one multi-source sweep of the solver, and answers are written
+// back as soon as their batch is done, in batch order rather than request order.
+// Sources that were solved before are answered straight from the result cache by the
+// connection's reader thread.
+class SsspServer
+{
+public:
+	SsspServer(Solver *solver, ServerOptions options);
+	~SsspServer();
+
+	int run();
+	void stop();
+	ServerStats stats();
+
+private:
+	struct Connection
+	{
+		int fd;
+		pthread_mutex_t write_mutex;
+
+		explicit Connection(int fd);
+		~Connection();
+		void send(const std::string &reply);
+	};
+
+	struct Request
+	{
+		std::shared_ptr<Connection> connection;
+		int source;
+		int target;
+		long long enqueue_time_us;
+	};
+
+	// one per connection, kept until run() has joined the thread
+	struct Reader
+	{
+		pthread_t thread;
+		// released by the thread when it is about to return
+		std::shared_ptr<Connection> connection;
+		bool finished;
+	};
+
+	struct ReaderArg
+	{
+		SsspServer *server;
+		Reader *reader;
+	};
+
+	static void *readerMain(void *arg);
+	static void *batcherMain(void *arg);
+	void readConnection(std::shared_ptr<Connection> connection);
+	void joinReaders(bool all);
+	void batchLoop();
+	void answerBatch(std::deque<Request> &batch);
+	std::string formatStats();
+
+	Solver *solver_;
+	ServerOptions options_;
+	int listen_fd_;
+	bool stopping_;
+	pthread_t batcher_;
+	pthread_mutex_t mutex_;
+	pthread_cond_t request_ready_;
+	std::deque<Request> queue_;
+	std::list<Reader> readers_;
+	ServerStats stats_;
+	std::unique_ptr<ResultCache> cache_;
+};
+
+#endif // SSSP_SERVER_H
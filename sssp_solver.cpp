@@ -0,0 +1,725 @@
+#include "sssp_solver.h"
+#include "distance_atomics.h"
+#include <algorithm> // For fill and max
+#include <cstdlib>	 // For free
+#include <cstring>	 // For memcpy
+
+using namespace std;
+
+/**
+ * @brief Maps an engine name ("bellman-ford", "push-pull", "async", "dijkstra", "auto", "scc", "spmv",
+ * "tarjan") to the engine.
+ *
+ * @return false if the name is unknown.
+ */
+bool parseSolverEngine(string name, SolverEngine *engine)
+{
+	if (name == "bellman-ford")
+		*engine = ENGINE_BELLMAN_FORD;
+	else if (name == "push-pull")
+		*engine = ENGINE_PUSH_PULL;
+	else if (name == "async")
+		*engine = ENGINE_ASYNC;
+	else if (name == "dijkstra")
+		*engine = ENGINE_DIJKSTRA;
+	else if (name == "auto")
+		*engine = ENGINE_AUTO;
+	else if (name == "scc")
+		*engine = ENGINE_SCC;
+	else if (name == "spmv")
+		*engine = ENGINE_SPMV;
+	else if (name == "tarjan")
+		*engine = ENGINE_TARJAN;
+	else
+		return false;
+	return true;
+}
+
+/**
+ * @brief The name parseSolverEngine accepts for an engine.
+ */
+const char *solverEngineName(SolverEngine engine)
+{
+	switch (engine)
+	{
+	case ENGINE_BELLMAN_FORD:
+		return "bellman-ford";
+	case ENGINE_PUSH_PULL:
+		return "push-pull";
+	case ENGINE_ASYNC:
+		return "async";
+	case ENGINE_DIJKSTRA:
+		return "dijkstra";
+	case ENGINE_AUTO:
+		return "auto";
+	case ENGINE_SCC:
+		return "scc";
+	case ENGINE_SPMV:
+		return "spmv";
+	case ENGINE_TARJAN:
+		return "tarjan";
+	}
+	return "unknown";
+}
+
+Solver::Solver(int num_threads)
+	: graph_(NULL), node_count_(0), rounds_(0), pull_rounds_(0), graph_version_(0), engine_(ENGINE_AUTO),
+	  arena_(arenaPageSizeFromEnvironment()), edges_in_arena_(false), node_arrays_in_arena_(false),
+	  numa_aware_(false), caller_cpu_(-1), distances_interleaved_(true), distances_spread_(false),
+	  distances_(NULL),
+	  batch_size_(0), hop_batch_size_(0), hop_stride_(0), min_weight_(0), max_weight_(0), layouts_ready_(false),
+	  csr_(), csc_(), changed_(NULL), frontier_(NULL),
+	  push_ns_per_edge_(0), pull_ns_per_edge_(0), scc_ready_(false), sell_ready_(false), sell_(), spmv_distances_(),
+	  pruning_(true), pruning_stats_(), source_node_id_(0), checkpoint_interval_(0), graph_checksum_(0),
+	  graph_checksum_ready_(false), edge_reduction_()
+{
+	pool_.start(num_threads);
+	thread_flags_.resize(pool_.size());
+	topology_ = detectNumaTopology();
+}
+
+Solver::~Solver()
+{
+	releasePartitions();
+	pool_.stop();
+	freeCsr(&csr_);
+	freeCsr(&csc_);
+	releaseGraph();
+}
+
+/**
+ * @brief Loads a graph from a .mtx or .bin file and prepares it for solving.
+ *
+ * @param input_graph_path The path to the graph file.
+ * @return SSSP_OK, or SSSP_ERROR_LOAD_FAILED if the file could not be read.
+ */
+int Solver::load(string input_graph_path)
+{
+	Graph *graph = ::loadGraph(input_graph_path);
+	if (graph == NULL || graph->edge == NULL)
+	{
+		freeGraph(graph);
+		return SSSP_ERROR_LOAD_FAILED;
+	}
+	return loadGraph(graph);
+}
+
+/**
+ * @brief Takes ownership of an in-memory graph and prepares it for solving.
+ *
+ * Any previously loaded graph is released.
+ *
+ * @param graph The graph to solve on, must have been allocated like readGraph does.
+ * @return SSSP_OK, SSSP_ERROR_INVALID_ARGUMENT if graph is NULL, or SSSP_ERROR_LOAD_FAILED
+ * if there is no memory for the distance arrays.
+ */
+int Solver::loadGraph(Graph *graph)
+{
+	if (graph == NULL)
+		return SSSP_ERROR_INVALID_ARGUMENT;
+
+	releasePartitions();
+	freeCsr(&csr_);
+	freeCsr(&csc_);
+	layouts_ready_ = false;
+	scc_ready_ = false;
+	sell_ready_ = false;
+	releaseGraph();
+	graph_ = graph;
+	graph_version_++;
+	graph_checksum_ready_ = false;
+	int status = prepare();
+	if (status != SSSP_OK)
+		releaseGraph();
+
+	return status;
+}
+
+/**
+ * @brief Frees the current graph and everything allocated from the arena for it.
+ */
+void Solver::releaseGraph()
+{
+	// the edge array belongs to the arena, freeGraph must not free() it
+	if (edges_in_arena_ && graph_ != NULL)
+		graph_->edge = NULL;
+	freeGraph(graph_);
+	graph_ = NULL;
+	edges_in_arena_ = false;
+	distances_spread_ = false;
+	if (!node_arrays_in_arena_)
+	{
+		free(distances_);
+		free(changed_);
+	}
+	node_arrays_in_arena_ = false;
+	distances_ = NULL;
+	changed_ = NULL;
+	frontier_ = NULL;
+	arena_.release();
+}
+
+/**
+ * @brief Builds everything a solve needs, once per graph.
+ *
+ * The node count is widened to cover every id used by an edge, since .mtx files are
+ * 1-based and readGraph keeps the ids as they are. Self-loops and parallel edges are
+ * then removed (see simplifyGraph) and the remaining edge list, sorted by source, is
+ * moved into the arena so that the relaxation loops stream it from huge pages. When the
+ * arena cannot map another chunk, the edges and the distance arrays stay on the heap.
+ *
+ * @return SSSP_OK, or SSSP_ERROR_LOAD_FAILED if the distance arrays could not be allocated.
+ */
+int Solver::prepare()
+{
+	node_count_ = graph_->no_of_nodes;
+	for (int i = 0; i < graph_->no_of_edges; i++)
+		node_count_ = max(node_count_, max(graph_->edge[i].source, graph_->edge[i].destination) + 1);
+
+	simplifyGraph(graph_, pool_, &edge_reduction_);
+	int no_of_edges = graph_->no_of_edges;
+
+	Edge *edges = arena_.allocateArray<Edge>(no_of_edges);
+	if (edges != NULL)
+	{
+		memcpy(edges, graph_->edge, (size_t)no_of_edges * sizeof(Edge));
+		free(graph_->edge);
+		graph_->edge = edges;
+		edges_in_arena_ = true;
+	}
+
+	min_weight_ = 0;
+	max_weight_ = 0;
+	for (int i = 0; i < no_of_edges; i++)
+	{
+		min_weight_ = min(min_weight_, graph_->edge[i].weight);
+		max_weight_ = max(max_weight_, graph_->edge[i].weight);
+	}
+
+	int num_threads = pool_.size();
+	int bsize = (no_of_edges + num_threads - 1) / num_threads;
+	partition_begin_.resize(num_threads + 1);
+	for (int tn = 0; tn <= num_threads; tn++)
+		partition_begin_[tn] = min(no_of_edges, tn * bsize);
+
+	distances_ = arena_.allocateArray<long>(node_count_);
+	changed_ = arena_.allocateArray<char>(node_count_);
+	node_arrays_in_arena_ = distances_ != NULL && changed_ != NULL;
+	if (!node_arrays_in_arena_)
+	{
+		distances_ = (long *)malloc((size_t)node_count_ * sizeof(long));
+		changed_ = (char *)calloc(node_count_, sizeof(char));
+		if (distances_ == NULL || changed_ == NULL)
+			return SSSP_ERROR_LOAD_FAILED;
+	}
+	fill(distances_, distances_ + node_count_, SSSP_INFINITY);
+	placePartitions();
+	rounds_ = 0;
+	batch_size_ = 0;
+	batch_distances_.clear();
+	hop_batch_size_ = 0;
+	hop_distances_.clear();
+	return SSSP_OK;
+}
+
+/**
+ * @brief Switches NUMA-aware execution on or off.
+ *
+ * When on, every worker thread is pinned to a CPU, threads are spread over the NUMA nodes
+ * in blocks, each thread's edge partition is copied into memory first touched by that
+ * thread on its own node, and the distance array is interleaved over all nodes so the
+ * random distance accesses spread their bandwidth evenly. Has no effect on machines with
+ * a single node besides pinning.
+ *
+ * Thread 0 is the application thread that calls into the solver, which need not be the
+ * same one every time, so it is not pinned here: every solve and the partition placement
+ * pin whichever thread calls them to thread 0's CPU and put its affinity back on return.
+ * Switching off also returns the distance array to the default memory policy.
+ *
+ * @param numa_aware Whether to place memory and threads by NUMA node.
+ */
+void Solver::setNumaAware(bool numa_aware)
+{
+	numa_aware_ = numa_aware;
+
+	vector<int> node_of_thread = assignThreadsToNodes(topology_, pool_.size());
+	vector<int> cpu_of_thread = assignThreadsToCpus(topology_, node_of_thread);
+	caller_cpu_ = numa_aware_ ? cpu_of_thread[0] : -1;
+	pool_.run([this, &cpu_of_thread](int tid)
+	{
+		if (tid == 0)
+			return;
+		if (numa_aware_)
+			pinCurrentThread(cpu_of_thread[tid]);
+		else
+			unpinCurrentThread(topology_);
+	});
+
+	if (graph_ != NULL)
+		placePartitions();
+}
+
+Solver::CallerPin::CallerPin(const Solver &solver)
+	: pinned_(false)
+{
+	if (solver.caller_cpu_ >= 0 && saveCurrentAffinity(&affinity_))
+		pinned_ = pinCurrentThread(solver.caller_cpu_);
+}
+
+Solver::CallerPin::~CallerPin()
+{
+	if (pinned_)
+		restoreAffinity(pthread_self(), affinity_);
+}
+
+/**
+ * @brief Switches the reachability pre-pass of the Bellman-Ford engine on or off.
+ *
+ * When on (the default), every Bellman-Ford solve first finds the nodes reachable from
+ * the source and, unless nearly all edges are reachable, relaxes only their edges (see
+ * pruneUnreachable and solvePruned). The pre-pass is skipped
+ * while checkpointing, whose snapshots need the full distance array after every round,
+ * and in NUMA-aware mode, whose node-local partitions the compact list would bypass.
+ */
+void Solver::setPruning(bool pruning)
+{
+	pruning_ = pruning;
+}
+
+/**
+ * @brief Points every thread at its edge partition, copying the partitions to node-local
+ * memory in NUMA-aware mode.
+ */
+void Solver::placePartitions()
+{
+	releasePartitions();
+
+	int num_threads = pool_.size();
+	partition_edges_.assign(num_threads, NULL);
+	partition_local_bytes_.assign(num_threads, 0);
+
+	distances_interleaved_ = true;
+	if (!numa_aware_)
+	{
+		for (int tn = 0; tn < num_threads; tn++)
+			partition_edges_[tn] = graph_->edge + partition_begin_[tn];
+		if (distances_spread_)
+			resetMemoryPolicy(distances_, (size_t)node_count_ * sizeof(long), topology_, arena_.pageBytesAt(distances_));
+		distances_spread_ = false;
+		return;
+	}
+
+	// each pinned thread allocates and first-touches its own partition
+	CallerPin caller_pin(*this);
+	pool_.run([this](int tid)
+	{
+		size_t bytes = (size_t)(partition_begin_[tid + 1] - partition_begin_[tid]) * sizeof(Edge);
+		Edge *local = (Edge *)allocateOnCurrentNode(bytes);
+		if (local != NULL)
+		{
+			memcpy(local, graph_->edge + partition_begin_[tid], bytes);
+			partition_edges_[tid] = local;
+			partition_local_bytes_[tid] = bytes;
+		}
+		else
+			partition_edges_[tid] = graph_->edge + partition_begin_[tid];
+	});
+
+	// explicit huge pages can only be placed whole, mbind rejects anything finer
+	distances_interleaved_ = interleaveMemory(distances_, (size_t)node_count_ * sizeof(long), topology_,
+											  arena_.pageBytesAt(distances_));
+	distances_spread_ = distances_interleaved_;
+}
+
+void Solver::releasePartitions()
+{
+	for (size_t tn = 0; tn < partition_local_bytes_.size(); tn++)
+	{
+		if (partition_local_bytes_[tn] > 0)
+			releaseNodeMemory(partition_edges_[tn], partition_local_bytes_[tn]);
+	}
+	partition_local_bytes_.clear();
+	partition_edges_.clear();
+}
+
+/**
+ * @brief Selects the engine used by solve(). Layouts the engine needs are built on its
+ * first solve and then kept for the lifetime of the graph.
+ *
+ * @return SSSP_OK, or SSSP_ERROR_INVALID_ARGUMENT for an unknown engine.
+ */
+int Solver::setEngine(SolverEngine engine)
+{
+	if (engine != ENGINE_BELLMAN_FORD && engine != ENGINE_PUSH_PULL && engine != ENGINE_ASYNC &&
+		engine != ENGINE_DIJKSTRA && engine != ENGINE_AUTO && engine != ENGINE_SCC &&
+		engine != ENGINE_SPMV && engine != ENGINE_TARJAN)
+		return SSSP_ERROR_INVALID_ARGUMENT;
+	engine_ = engine;
+	return SSSP_OK;
+}
+
+/**
+ * @brief The engine the next solve runs on the loaded graph.
+ *
+ * ENGINE_AUTO picks Dijkstra when no weight is negative. Dijkstra cannot handle negative
+ * weights, so on such graphs it falls back to Bellman-Ford as well.
+ */
+SolverEngine Solver::activeEngine() const
+{
+	if (engine_ == ENGINE_AUTO || engine_ == ENGINE_DIJKSTRA)
+		return min_weight_ >= 0 ? ENGINE_DIJKSTRA : ENGINE_BELLMAN_FORD;
+	return engine_;
+}
+
+/**
+ * @brief Builds the layouts the active engine needs, which its first solve does otherwise.
+ *
+ * Lets a freshly loaded graph be made ready before it receives queries, so the first
+ * query does not pay for the layouts.
+ *
+ * @return SSSP_OK, SSSP_ERROR_NO_GRAPH, or SSSP_ERROR_OUT_OF_MEMORY if the arena could
+ * not hold the layouts.
+ */
+int Solver::prepareEngine()
+{
+	if (graph_ == NULL)
+		return SSSP_ERROR_NO_GRAPH;
+
+	SolverEngine engine = activeEngine();
+	bool prepared = true;
+	if (engine == ENGINE_PUSH_PULL)
+		prepared = prepareLayouts();
+	else if (engine == ENGINE_DIJKSTRA || engine == ENGINE_TARJAN || (engine == ENGINE_BELLMAN_FORD && pruning_))
+		prepared = prepareCsr();
+	else if (engine == ENGINE_SCC)
+		prepared = prepareScc();
+	else if (engine == ENGINE_SPMV)
+		prepared = prepareSell();
+	return prepared ? SSSP_OK : SSSP_ERROR_OUT_OF_MEMORY;
+}
+
+/**
+ * @brief Computes the shortest distances from a source node to all other nodes.
+ *
+ * Runs synchronous Bellman-Ford rounds on the worker pool: in every round each thread
+ * relaxes its partition of the edges with an atomic min, and the solve stops after the
+ * first round without any relaxation or after no_of_nodes - 1 rounds.
+ *
+ * @param source_node_id The ID of the source node.
+ * @return SSSP_OK, SSSP_NEGATIVE_CYCLE if a negative cycle is reachable from the source,
+ * SSSP_ERROR_NO_GRAPH, SSSP_ERROR_INVALID_SOURCE, or SSSP_ERROR_OUT_OF_MEMORY if the
+ * layouts of the engine could not be built.
+ */
+int Solver::solve(int source_node_id)
+{
+	if (graph_ == NULL)
+		return SSSP_ERROR_NO_GRAPH;
+	if (source_node_id < 0 || source_node_id >= node_count_)
+		return SSSP_ERROR_INVALID_SOURCE;
+
+	source_node_id_ = source_node_id;
+	fill(distances_, distances_ + node_count_, SSSP_INFINITY);
+	fill(changed_, changed_ + node_count_, 0);
+	distances_[source_node_id] = 0;
+	changed_[source_node_id] = 1;
+
+	rounds_ = 0;
+	CallerPin caller_pin(*this);
+	return runEngine();
+}
+
+/**
+ * @brief Runs the selected engine from the current state until it converges.
+ *
+ * The state is either fresh from solve() or restored by resume(): distances_, changed_
+ * (the nodes improved in the last completed round) and rounds_.
+ */
+int Solver::runEngine()
+{
+	SolverEngine engine = activeEngine();
+	pruning_stats_ = PruningStats();
+	if (engine == ENGINE_PUSH_PULL)
+		return solvePushPull();
+	if (engine == ENGINE_ASYNC)
+		return solveAsync();
+	if (engine == ENGINE_DIJKSTRA)
+		return solveDijkstra();
+	if (engine == ENGINE_SCC)
+		return solveScc();
+	if (engine == ENGINE_SPMV)
+		return solveSpmv();
+	if (engine == ENGINE_TARJAN)
+		return solveTarjan();
+	if (pruning_ && checkpoint_interval_ == 0 && !numa_aware_ && pruneUnreachable())
+		return solvePruned();
+
+	// the Bellman-Ford engine only records improved nodes for checkpoints
+	bool track_active = checkpoint_interval_ > 0;
+	while (rounds_ < node_count_ - 1)
+	{
+		if (track_active)
+			fill(changed_, changed_ + node_count_, 0);
+		rounds_++;
+		if (!relaxRound())
+			break;
+		checkpointRound();
+	}
+
+	return hasNegativeCycle() ? SSSP_NEGATIVE_CYCLE : SSSP_OK;
+}
+
+/**
+ * @brief Enables periodic checkpoints of single source solves.
+ *
+ * Every interval_rounds rounds the distances, the nodes improved in the last round and
+ * the parent array derived from them are written to path in the background (see
+ * CheckpointWriter), replacing the previous checkpoint. resume() continues from it.
+ *
+ * @param path File the checkpoints are written to.
+ * @param interval_rounds Rounds between checkpoints, 0 disables checkpointing.
+ * @return SSSP_OK, or SSSP_ERROR_INVALID_ARGUMENT.
+ */
+int Solver::setCheckpoint(string path, int interval_rounds)
+{
+	if (interval_rounds < 0 || (interval_rounds > 0 && path.empty()))
+		return SSSP_ERROR_INVALID_ARGUMENT;
+
+	checkpoint_writer_.wait();
+	checkpoint_path_ = path;
+	checkpoint_interval_ = interval_rounds;
+	return SSSP_OK;
+}
+
+/**
+ * @brief Takes a checkpoint if one is due after the round just completed.
+ *
+ * Called between rounds, while the worker threads are idle. Costs a fork when a
+ * checkpoint is due and nothing otherwise; a checkpoint that is due while the previous
+ * one is still being written is skipped.
+ */
+void Solver::checkpointRound()
+{
+	if (checkpoint_interval_ == 0 || rounds_ % checkpoint_interval_ != 0)
+		return;
+
+	if (!graph_checksum_ready_)
+	{
+		graph_checksum_ = graphChecksum(graph_);
+		graph_checksum_ready_ = true;
+	}
+
+	CheckpointHeader header;
+	header.magic = CHECKPOINT_MAGIC;
+	header.format_version = CHECKPOINT_FORMAT_VERSION;
+	header.no_of_nodes = node_count_;
+	header.no_of_edges = graph_->no_of_edges;
+	header.source_node_id = source_node_id_;
+	header.round = rounds_;
+	header.graph_checksum = graph_checksum_;
+	checkpoint_writer_.snapshot(checkpoint_path_, header, distances_, changed_, graph_);
+}
+
+/**
+ * @brief Continues an interrupted solve from a checkpoint file.
+ *
+ * The checkpoint must belong to the loaded graph. The solve resumes at the round after
+ * the checkpoint with the current engine, which need not be the one that wrote it.
+ *
+ * @param path A checkpoint written by an earlier solve.
+ * @return Like solve(), or SSSP_ERROR_LOAD_FAILED if the file cannot be read and
+ * SSSP_ERROR_INVALID_ARGUMENT if it belongs to another graph.
+ */
+int Solver::resume(string path)
+{
+	if (graph_ == NULL)
+		return SSSP_ERROR_NO_GRAPH;
+
+	Checkpoint checkpoint;
+	if (!readCheckpoint(path, &checkpoint))
+		return SSSP_ERROR_LOAD_FAILED;
+
+	if (!graph_checksum_ready_)
+	{
+		graph_checksum_ = graphChecksum(graph_);
+		graph_checksum_ready_ = true;
+	}
+	const CheckpointHeader &header = checkpoint.header;
+	if (header.no_of_nodes != node_count_ || header.no_of_edges != graph_->no_of_edges ||
+		header.graph_checksum != graph_checksum_ || header.source_node_id < 0 ||
+		header.source_node_id >= node_count_ || header.round < 0)
+		return SSSP_ERROR_INVALID_ARGUMENT;
+
+	source_node_id_ = header.source_node_id;
+	copy(checkpoint.distances.begin(), checkpoint.distances.end(), distances_);
+	copy(checkpoint.active.begin(), checkpoint.active.end(), changed_);
+	rounds_ = header.round;
+	CallerPin caller_pin(*this);
+	return runEngine();
+}
+
+/**
+ * @brief Relaxes every edge once, in parallel.
+ *
+ * @return true if at least one distance was lowered.
+ */
+bool Solver::relaxRound()
+{
+	pool_.run([this](int tid)
+	{
+		long *node_distances = distances_;
+		const Edge *edges = partition_edges_[tid];
+		int partition_size = partition_begin_[tid + 1] - partition_begin_[tid];
+		bool track_active = checkpoint_interval_ > 0;
+		bool relaxed = false;
+
+		for (int j = 0; j < partition_size; j++)
+		{
+			const Edge &edge = edges[j];
+			long source_distance = loadDistance(&node_distances[edge.source]);
+
+			if (source_distance < SSSP_INFINITY &&
+				atomicMinDistance(&node_distances[edge.destination], source_distance + edge.weight))
+			{
+				relaxed = true;
+				if (track_active)
+					atomic_ref<char>(changed_[edge.destination]).store(1, memory_order_relaxed);
+			}
+		}
+
+		thread_flags_[tid].value = relaxed;
+	});
+
+	for (const ThreadFlag &flag : thread_flags_)
+	{
+		if (flag.value)
+			return true;
+	}
+	return false;
+}
+
+/**
+ * @brief Checks whether any edge can still be relaxed, which after a converged solve
+ * means a negative weight cycle is reachable from the source.
+ */
+bool Solver::hasNegativeCycle()
+{
+	pool_.run([this](int tid)
+	{
+		const long *node_distances = distances_;
+		const Edge *edges = partition_edges_[tid];
+		int partition_size = partition_begin_[tid + 1] - partition_begin_[tid];
+		bool found = false;
+
+		for (int j = 0; j < partition_size && !found; j++)
+		{
+			const Edge &edge = edges[j];
+			if (node_distances[edge.source] < SSSP_INFINITY &&
+				node_distances[edge.source] + edge.weight < node_distances[edge.destination])
+				found = true;
+		}
+
+		thread_flags_[tid].value = found;
+	});
+
+	for (const ThreadFlag &flag : thread_flags_)
+	{
+		if (flag.value)
+			return true;
+	}
+	return false;
+}
+
+/**
+ * @brief Computes the distances from up to SOLVER_MAX_BATCH sources in one sweep.
+ *
+ * All sources share the same rounds: every edge is loaded once per round and relaxed for
+ * every source, so answering a batch costs little more memory traffic than one solve.
+ * Distances are read back with batchDistance and negative cycles with batchNegativeCycle.
+ *
+ * @param source_node_ids The sources, duplicates are allowed.
+ * @param count Number of sources, between 1 and SOLVER_MAX_BATCH.
+ * @return SSSP_OK, SSSP_NEGATIVE_CYCLE if any source reaches a negative cycle, or an error code.
+ */
+int Solver::solveBatch(const int *source_node_ids, int count)
+{
+	if (graph_ == NULL)
+		return SSSP_ERROR_NO_GRAPH;
+	if (count < 1 || count > SOLVER_MAX_BATCH)
+		return SSSP_ERROR_INVALID_ARGUMENT;
+	for (int lane = 0; lane < count; lane++)
+	{
+		if (source_node_ids[lane] < 0 || source_node_ids[lane] >= node_count_)
+			return SSSP_ERROR_INVALID_SOURCE;
+	}
+
+	batch_size_ = count;
+	batch_distances_.assign((size_t)node_count_ * count, SSSP_INFINITY);
+	for (int lane = 0; lane < count; lane++)
+		batch_distances_[(size_t)source_node_ids[lane] * count + lane] = 0;
+
+	CallerPin caller_pin(*this);
+	rounds_ = 0;
+	while (rounds_ < node_count_ - 1)
+	{
+		rounds_++;
+		if (!relaxBatchRound())
+			break;
+	}
+
+	// lanes that still improve after no_of_nodes - 1 rounds reach a negative cycle
+	batch_negative_cycle_.assign(count, 0);
+	bool negative_cycle = false;
+	if (rounds_ == node_count_ - 1)
+	{
+		vector<long> before = batch_distances_;
+		negative_cycle = relaxBatchRound();
+		for (size_t i = 0; negative_cycle && i < before.size(); i++)
+		{
+			if (batch_distances_[i] != before[i])
+				batch_negative_cycle_[i % count] = 1;
+		}
+	}
+
+	return negative_cycle ? SSSP_NEGATIVE_CYCLE : SSSP_OK;
+}
+
+/**
+ * @brief Relaxes every edge once for every lane of the current batch, in parallel.
+ *
+ * @return true if at least one distance of any lane was lowered.
+ */
+bool Solver::relaxBatchRound()
+{
+	pool_.run([this](int tid)
+	{
+		long *node_distances = batch_distances_.data();
+		const Edge *edges = partition_edges_[tid];
+		int partition_size = partition_begin_[tid + 1] - partition_begin_[tid];
+		int lanes = batch_size_;
+		bool relaxed = false;
+
+		for (int j = 0; j < partition_size; j++)
+		{
+			const Edge &edge = edges[j];
+			long *source_distances = node_distances + (size_t)edge.source * lanes;
+			long *destination_distances = node_distances + (size_t)edge.destination * lanes;
+
+			for (int lane = 0; lane < lanes; lane++)
+			{
+				long source_distance = loadDistance(&source_distances[lane]);
+				if (source_distance < SSSP_INFINITY &&
+					atomicMinDistance(&destination_distances[lane], source_distance + edge.weight))
+					relaxed = true;
+			}
+		}
+
+		thread_flags_[tid].value = relaxed;
+	});
+
+	for (const ThreadFlag &flag : thread_flags_)
+	{
+		if (flag.value)
+			return true;
+	}
+	return false;
+}
@@ -0,0 +1,279 @@
+#ifndef SSSP_SOLVER_H
+#define SSSP_SOLVER_H
+
+#include <string>
+#include <vector>
+#include "graph.h"
+#include "arena.h"
+#include "bucket_queues.h"
+#include "checkpoint.h"
+#include "csr.h"
+#include "edge_preprocessing.h"
+#include "numa_topology.h"
+#include "scc.h"
+#include "sell.h"
+#include "sssp_c_api.h"
+#include "thread_pool.h"
+
+// largest number of sources answered by one multi-source sweep
+const int SOLVER_MAX_BATCH = 16;
+
+// hop-bounded solves pad the lanes of every node to a multiple of this, one AVX2 vector
+// of 64-bit distances
+const int HOP_LANE_WIDTH = 4;
+const int HOP_MAX_STRIDE = (SOLVER_MAX_BATCH + HOP_LANE_WIDTH - 1) / HOP_LANE_WIDTH * HOP_LANE_WIDTH;
+
+// largest edge weight for which the Dijkstra engine uses Dial's buckets instead of a radix heap
+const int DIAL_MAX_WEIGHT = 4096;
+
+// the pruned Bellman-Ford engine only compacts the edge list when the nodes reachable
+// from the source own at most this share of the edges
+const double PRUNING_MAX_REACHABLE_SHARE = 0.9;
+
+// strongly connected components with at least this many internal edges are relaxed by
+// all threads together, smaller ones by a single thread each
+const int SCC_PARALLEL_MIN_EDGES = 65536;
+
+// relaxation engine used by Solver::solve
+enum SolverEngine
+{
+	// synchronous rounds over the edge list, every edge pushed every round
+	ENGINE_BELLMAN_FORD = SSSP_ENGINE_BELLMAN_FORD,
+	// frontier based rounds switching between push over CSR and pull over CSC
+	ENGINE_PUSH_PULL = SSSP_ENGINE_PUSH_PULL,
+	// no rounds, threads sweep their edges continuously until quiescence is detected
+	ENGINE_ASYNC = SSSP_ENGINE_ASYNC,
+	// serial Dijkstra with a bucket queue, only valid without negative weights
+	ENGINE_DIJKSTRA = SSSP_ENGINE_DIJKSTRA,
+	// Dijkstra when every weight is non-negative, Bellman-Ford otherwise
+	ENGINE_AUTO = SSSP_ENGINE_AUTO,
+	// Bellman-Ford inside each strongly connected component, in topological order
+	ENGINE_SCC = SSSP_ENGINE_SCC,
+	// synchronous rounds as min-plus SpMV, pulling over a SELL-C-sigma layout with SIMD
+	ENGINE_SPMV = SSSP_ENGINE_SPMV,
+	// serial label-correcting queue with subtree disassembly, stops at the first negative cycle
+	ENGINE_TARJAN = SSSP_ENGINE_TARJAN
+};
+
+bool parseSolverEngine(std::string name, SolverEngine *engine);
+const char *solverEngineName(SolverEngine engine);
+
+// reachability pre-pass of the last solve, all zero unless it was a pruned Bellman-Ford solve
+struct PruningStats
+{
+	int reachable_nodes;
+	// edges leaving the reachable nodes
+	int reachable_edges;
+	// whether those edges were compacted, see PRUNING_MAX_REACHABLE_SHARE
+	bool compacted;
+	// time spent on the BFS, the renumbering and the compaction
+	long long prepass_ns;
+	// edge scans the rounds did not do compared with relaxing the whole edge list
+	long long skipped_edge_scans;
+};
+
+// Long-lived single source shortest path solver.
+//
+// The solver owns the graph, its thread partitions, a pool of worker threads and all
+// scratch buffers. Everything is prepared once when a graph is loaded, so repeated
+// solve() calls for different sources do no allocation and no thread creation.
+class Solver
+{
+public:
+	explicit Solver(int num_threads);
+	~Solver();
+
+	int load(std::string input_graph_path);
+	int loadGraph(Graph *graph);
+
+	int setEngine(SolverEngine engine);
+	SolverEngine activeEngine() const;
+	void setNumaAware(bool numa_aware);
+	void setPruning(bool pruning);
+	int prepareEngine();
+	int solve(int source_node_id);
+	int solveBatch(const int *source_node_ids, int count);
+	int solveHops(const int *source_node_ids, int count, int max_hops);
+	int setCheckpoint(std::string path, int interval_rounds);
+	int resume(std::string path);
+
+	int nodeCount() const { return node_count_; }
+	const long *distances() const { return distances_; }
+	int rounds() const { return rounds_; }
+	// how many rounds of the last push/pull solve pulled instead of pushed
+	int pullRounds() const { return pull_rounds_; }
+	const Graph *graph() const { return graph_; }
+	const PruningStats &pruningStats() const { return pruning_stats_; }
+	// components of the graph, valid after the first solve with the SCC engine
+	const SccDecomposition &sccDecomposition() const { return scc_; }
+	// self-loops and parallel edges removed from the loaded graph
+	const EdgeReduction &edgeReduction() const { return edge_reduction_; }
+	// checkpoints completely written since the solver was created
+	int checkpointsWritten() const { return checkpoint_writer_.completed(); }
+	int numThreads() const { return pool_.size(); }
+	// false if NUMA-aware mode could not spread the distance array over the nodes
+	bool distancesInterleaved() const { return distances_interleaved_; }
+	// incremented by every load, results computed for an older version are stale
+	unsigned long long graphVersion() const { return graph_version_; }
+
+	// results of the last solveBatch, lane i belongs to source_node_ids[i]
+	long batchDistance(int lane, int node) const { return batch_distances_[(size_t)node * batch_size_ + lane]; }
+	bool batchNegativeCycle(int lane) const { return batch_negative_cycle_[lane]; }
+	const long *batchDistances() const { return batch_distances_.data(); }
+	int batchSize() const { return batch_size_; }
+	// results of the last solveHops, lane i belongs to source_node_ids[i]
+	long hopDistance(int lane, int node) const { return hop_distances_[(size_t)node * hop_stride_ + lane]; }
+	int hopBatchSize() const { return hop_batch_size_; }
+
+private:
+	void releaseGraph();
+	int prepare();
+	void placePartitions();
+	void releasePartitions();
+	bool relaxRound();
+	bool hasNegativeCycle();
+	bool relaxBatchRound();
+	int runEngine();
+	void checkpointRound();
+	bool prepareLayouts();
+	int solvePushPull();
+	int solveAsync();
+	int solveDijkstra();
+	bool pruneUnreachable();
+	bool prepareScc();
+	int solveScc();
+	bool prepareSell();
+	int solveSpmv();
+	int solveTarjan();
+	int solvePruned();
+	bool prepareCsr();
+	bool prepareCsc();
+	int collectFrontier(long long *frontier_edges);
+	void pushRound(int frontier_size);
+	void pullRound();
+
+	// per-thread flag and counters, padded so threads do not share a cache line
+	// pins the calling thread to caller_cpu_ for one call and gives it its affinity back
+	class CallerPin
+	{
+	public:
+		explicit CallerPin(const Solver &solver);
+		~CallerPin();
+
+	private:
+		bool pinned_;
+		cpu_set_t affinity_;
+	};
+
+	struct alignas(64) ThreadFlag
+	{
+		bool value;
+		long long count;
+		long long work;
+	};
+
+	Graph *graph_;
+	int node_count_;
+	int rounds_;
+	int pull_rounds_;
+	unsigned long long graph_version_;
+	SolverEngine engine_;
+	// edges, distances, layouts and frontier buffers of the current graph, released on reload
+	Arena arena_;
+	// whether graph_->edge points into arena_ rather than to the loader's malloc'd array
+	bool edges_in_arena_;
+	// whether distances_ and changed_ are in arena_ rather than malloc'd
+	bool node_arrays_in_arena_;
+	ThreadPool pool_;
+	// thread tn relaxes the edges [partition_begin_[tn], partition_begin_[tn + 1]),
+	// read from partition_edges_[tn], which is a node-local copy in NUMA-aware mode
+	std::vector<int> partition_begin_;
+	std::vector<Edge *> partition_edges_;
+	// size of each node-local copy, 0 where the thread reads the shared edge list
+	std::vector<size_t> partition_local_bytes_;
+	bool numa_aware_;
+	// CPU of thread 0, -1 unless NUMA-aware. Thread 0 is whichever thread calls in, so it
+	// is only pinned for the duration of a call (see CallerPin).
+	int caller_cpu_;
+	// false if the kernel refused to interleave the distance array in NUMA-aware mode
+	bool distances_interleaved_;
+	// whether the distance array currently has the interleave policy
+	bool distances_spread_;
+	NumaTopology topology_;
+	long *distances_;
+	std::vector<ThreadFlag> thread_flags_;
+	// batch_size_ distances per node, interleaved so one edge updates all lanes at once
+	int batch_size_;
+	std::vector<long> batch_distances_;
+	std::vector<char> batch_negative_cycle_;
+	// hop-bounded solves: hop_stride_ distances per node (hop_batch_size_ lanes and the
+	// padding), the nodes improved in the last hop, the claimed flags of the candidates,
+	// and per thread its candidates, their next distances and the improved ones
+	int hop_batch_size_;
+	int hop_stride_;
+	std::vector<long> hop_distances_;
+	std::vector<int> hop_frontier_;
+	std::vector<char> hop_marked_;
+	std::vector<std::vector<int>> hop_candidates_;
+	std::vector<std::vector<long>> hop_next_;
+	std::vector<std::vector<int>> hop_improved_;
+
+	// smallest and largest edge weight of the graph
+	int min_weight_;
+	int max_weight_;
+	// Dijkstra engine queues, kept so repeated solves reuse their memory
+	DialQueue dial_queue_;
+	RadixHeap radix_heap_;
+
+	// push/pull engine: outgoing and incoming layouts, built on first use
+	bool layouts_ready_;
+	CsrGraph csr_;
+	CsrGraph csc_;
+	// nodes improved in the last round, as flags and as a list
+	char *changed_;
+	int *frontier_;
+	std::vector<int> frontier_offsets_;
+	// measured cost per edge of each direction, used to pick the cheaper one
+	double push_ns_per_edge_;
+	double pull_ns_per_edge_;
+
+	// SCC engine: the component decomposition, built on first use
+	bool scc_ready_;
+	SccDecomposition scc_;
+
+	// SpMV engine: the layout, the distance vectors of the last and the current round in
+	// row order, and the chunks [spmv_partition_[tn], spmv_partition_[tn + 1]) of thread tn
+	bool sell_ready_;
+	SellGraph sell_;
+	long *spmv_distances_[2];
+	std::vector<int> spmv_partition_;
+	// Tarjan engine: the shortest path tree as a preorder list with node depths (-1 outside
+	// the tree), the queued flags, and the nodes queued for the current and the next pass
+	std::vector<int> tarjan_next_;
+	std::vector<int> tarjan_prev_;
+	std::vector<int> tarjan_depth_;
+	std::vector<char> tarjan_queued_;
+	std::vector<int> tarjan_pass_[2];
+
+	// pruned Bellman-Ford: new id of every node (-1 if unreachable), the BFS frontiers, and
+	// the compact edge list and distances of the reachable part
+	bool pruning_;
+	std::vector<int> prune_ids_;
+	std::vector<int> prune_frontier_;
+	std::vector<std::vector<int>> prune_next_;
+	std::vector<Edge> prune_edges_;
+	std::vector<long> prune_distances_;
+	PruningStats pruning_stats_;
+
+	// checkpointing: a snapshot every checkpoint_interval_ rounds, 0 disables it
+	int source_node_id_;
+	std::string checkpoint_path_;
+	int checkpoint_interval_;
+	CheckpointWriter checkpoint_writer_;
+	// graphChecksum of the current graph, computed on first use
+	unsigned long long graph_checksum_;
+	bool graph_checksum_ready_;
+	EdgeReduction edge_reduction_;
+};
+
+#endif // SSSP_SOLVER_H
@@ -0,0 +1,80 @@
+#include "task_executor.h"
+
+using namespace std;
+
+TaskExecutor::TaskExecutor() : stopping_(false)
+{
+	pthread_mutex_init(&mutex_, NULL);
+	pthread_cond_init(&work_ready_, NULL);
+}
+
+TaskExecutor::~TaskExecutor()
+{
+	stop();
+	pthread_mutex_destroy(&mutex_);
+	pthread_cond_destroy(&work_ready_);
+}
+
+/**
+ * @brief Starts num_threads workers that resume the scheduled coroutines.
+ *
+ * Unlike ThreadPool, the calling thread is not one of them: it stays free to start tasks
+ * and wait for them.
+ */
+void TaskExecutor::start(int num_threads)
+{
+	stop();
+
+	stopping_ = false;
+	threads_.resize(num_threads > 0 ? num_threads : 1);
+	for (pthread_t &thread : threads_)
+		pthread_create(&thread, NULL, workerMain, this);
+}
+
+/**
+ * @brief Lets the workers finish the coroutines already scheduled, then joins them.
+ */
+void TaskExecutor::stop()
+{
+	if (threads_.empty())
+		return;
+
+	pthread_mutex_lock(&mutex_);
+	stopping_ = true;
+	pthread_cond_broadcast(&work_ready_);
+	pthread_mutex_unlock(&mutex_);
+
+	for (pthread_t thread : threads_)
+		pthread_join(thread, NULL);
+	threads_.clear();
+}
+
+void TaskExecutor::enqueue(coroutine_handle<> handle)
+{
+	pthread_mutex_lock(&mutex_);
+	queue_.push_back(handle);
+	pthread_cond_signal(&work_ready_);
+	pthread_mutex_unlock(&mutex_);
+}
+
+void *TaskExecutor::workerMain(void *arg)
+{
+	TaskExecutor *executor = (TaskExecutor *)arg;
+
+	while (true)
+	{
+		pthread_mutex_lock(&executor->mutex_);
+		while (executor->queue_.empty() && !executor->stopping_)
+			pthread_cond_wait(&executor->work_ready_, &executor->mutex_);
+		if (executor->queue_.empty())
+		{
+			pthread_mutex_unlock(&executor->mutex_);
+			return NULL;
+		}
+		coroutine_handle<> handle = executor->queue_.front();
+		executor->queue_.pop_front();
+		pthread_mutex_unlock(&executor->mutex_);
+
+		handle.resume();
+	}
+}
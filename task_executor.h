@@ -0,0 +1,178 @@
+#ifndef TASK_EXECUTOR_H
+#define TASK_EXECUTOR_H
+
+#include <pthread.h>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Shared set of pthreads that resume coroutines.
+//
+// A coroutine moves itself onto the executor with co_await executor->schedule() and
+// then runs on whichever worker picks it up, until its next co_await. Loads, layout
+// building and solves of different graph versions can run side by side this way.
+class TaskExecutor
+{
+public:
+	struct ScheduleAwaiter
+	{
+		TaskExecutor *executor;
+
+		bool await_ready() const noexcept { return false; }
+		void await_suspend(std::coroutine_handle<> handle) { executor->enqueue(handle); }
+		void await_resume() const noexcept {}
+	};
+
+	TaskExecutor();
+	~TaskExecutor();
+
+	void start(int num_threads);
+	void stop();
+	ScheduleAwaiter schedule() { return ScheduleAwaiter{this}; }
+	int size() const { return threads_.size(); }
+
+private:
+	static void *workerMain(void *arg);
+	void enqueue(std::coroutine_handle<> handle);
+
+	std::vector<pthread_t> threads_;
+	pthread_mutex_t mutex_;
+	pthread_cond_t work_ready_;
+	std::deque<std::coroutine_handle<>> queue_;
+	bool stopping_;
+};
+
+// Lazily started coroutine producing a T.
+//
+// A task does nothing until it is either awaited with co_await from another coroutine,
+// which resumes the awaiting coroutine when the task is done, or started with start()
+// and collected with get(), which blocks the calling thread. A task is used one way or
+// the other, never both.
+template <typename T>
+class Task
+{
+public:
+	struct promise_type
+	{
+		std::optional<T> value;
+		std::exception_ptr exception;
+		std::coroutine_handle<> continuation;
+		// completion of a started task, for get()
+		pthread_mutex_t mutex;
+		pthread_cond_t finished;
+		bool done;
+
+		promise_type() : done(false)
+		{
+			pthread_mutex_init(&mutex, NULL);
+			pthread_cond_init(&finished, NULL);
+		}
+
+		~promise_type()
+		{
+			pthread_mutex_destroy(&mutex);
+			pthread_cond_destroy(&finished);
+		}
+
+		struct FinalAwaiter
+		{
+			bool await_ready() const noexcept { return false; }
+			void await_resume() const noexcept {}
+
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+			{
+				promise_type &promise = handle.promise();
+				if (promise.continuation)
+					return promise.continuation;
+
+				// the waiter may destroy the frame as soon as the mutex is released
+				pthread_mutex_lock(&promise.mutex);
+				promise.done = true;
+				pthread_cond_broadcast(&promise.finished);
+				pthread_mutex_unlock(&promise.mutex);
+				return std::noop_coroutine();
+			}
+		};
+
+		Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		FinalAwaiter final_suspend() noexcept { return {}; }
+		void return_value(T result) { value.emplace(std::move(result)); }
+		void unhandled_exception() { exception = std::current_exception(); }
+	};
+
+	explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle), started_(false) {}
+	Task(Task &&other) noexcept : handle_(std::exchange(other.handle_, nullptr)), started_(other.started_) {}
+	Task(const Task &) = delete;
+	Task &operator=(const Task &) = delete;
+
+	~Task()
+	{
+		if (handle_)
+			handle_.destroy();
+	}
+
+	bool await_ready() const noexcept { return false; }
+
+	std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting)
+	{
+		handle_.promise().continuation = awaiting;
+		return handle_;
+	}
+
+	T await_resume() { return result(); }
+
+	/**
+	 * @brief Runs the task up to its first suspension, usually its move onto an executor.
+	 */
+	void start()
+	{
+		if (!started_)
+		{
+			started_ = true;
+			handle_.resume();
+		}
+	}
+
+	/**
+	 * @brief Starts the task if needed and blocks until it is done.
+	 */
+	T get()
+	{
+		start();
+		promise_type &promise = handle_.promise();
+		pthread_mutex_lock(&promise.mutex);
+		while (!promise.done)
+			pthread_cond_wait(&promise.finished, &promise.mutex);
+		pthread_mutex_unlock(&promise.mutex);
+		return result();
+	}
+
+private:
+	T result()
+	{
+		promise_type &promise = handle_.promise();
+		if (promise.exception)
+			std::rethrow_exception(promise.exception);
+		return std::move(*promise.value);
+	}
+
+	std::coroutine_handle<promise_type> handle_;
+	bool started_;
+};
+
+/**
+ * @brief Wraps a blocking function, such as a download, into a task run on the executor.
+ */
+template <typename Function>
+Task<std::invoke_result_t<Function>> runOnExecutor(TaskExecutor *executor, Function function)
+{
+	co_await executor->schedule();
+	co_return function();
+}
+
+#endif // TASK_EXECUTOR_H
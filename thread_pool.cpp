@@ -0,0 +1,125 @@
+#include "thread_pool.h"
+
+using namespace std;
+
+ThreadPool::ThreadPool() : num_threads_(0), task_(NULL), generation_(0), pending_(0), stopping_(false)
+{
+	pthread_mutex_init(&mutex_, NULL);
+	pthread_cond_init(&work_ready_, NULL);
+	pthread_cond_init(&work_done_, NULL);
+}
+
+ThreadPool::~ThreadPool()
+{
+	stop();
+	pthread_mutex_destroy(&mutex_);
+	pthread_cond_destroy(&work_ready_);
+	pthread_cond_destroy(&work_done_);
+}
+
+/**
+ * @brief Starts num_threads workers. Thread 0 is the calling thread itself, so only
+ * num_threads - 1 pthreads are created.
+ *
+ * @param num_threads The number of threads that run every task.
+ */
+void ThreadPool::start(int num_threads)
+{
+	stop();
+
+	num_threads_ = num_threads > 0 ? num_threads : 1;
+	stopping_ = false;
+	threads_.resize(num_threads_);
+	worker_args_.resize(num_threads_);
+
+	for (int tn = 1; tn < num_threads_; tn++)
+	{
+		worker_args_[tn].pool = this;
+		worker_args_[tn].tid = tn;
+		worker_args_[tn].start_generation = generation_;
+		pthread_create(&threads_[tn], NULL, workerMain, &worker_args_[tn]);
+	}
+}
+
+/**
+ * @brief Stops and joins all workers. The pool can be started again afterwards.
+ */
+void ThreadPool::stop()
+{
+	if (num_threads_ == 0)
+		return;
+
+	pthread_mutex_lock(&mutex_);
+	stopping_ = true;
+	pthread_cond_broadcast(&work_ready_);
+	pthread_mutex_unlock(&mutex_);
+
+	for (int tn = 1; tn < num_threads_; tn++)
+		pthread_join(threads_[tn], NULL);
+
+	num_threads_ = 0;
+	threads_.clear();
+	worker_args_.clear();
+}
+
+/**
+ * @brief Runs task(tid) on every thread of the pool and returns when all of them are done.
+ *
+ * The return of run() acts as a barrier, so a round-based algorithm calls it once per round.
+ *
+ * @param task The function to run, called with the thread id in [0, size()).
+ */
+void ThreadPool::run(const function<void(int)> &task)
+{
+	if (num_threads_ <= 1)
+	{
+		task(0);
+		return;
+	}
+
+	pthread_mutex_lock(&mutex_);
+	task_ = &task;
+	pending_ = num_threads_ - 1;
+	generation_++;
+	pthread_cond_broadcast(&work_ready_);
+	pthread_mutex_unlock(&mutex_);
+
+	task(0);
+
+	pthread_mutex_lock(&mutex_);
+	while (pending_ > 0)
+		pthread_cond_wait(&work_done_, &mutex_);
+	task_ = NULL;
+	pthread_mutex_unlock(&mutex_);
+}
+
+void *ThreadPool::workerMain(void *arg)
+{
+	WorkerArg *worker = (WorkerArg *)arg;
+	ThreadPool *pool = worker->pool;
+	unsigned long long seen_generation = worker->start_generation;
+
+	while (true)
+	{
+		pthread_mutex_lock(&pool->mutex_);
+		while (!pool->stopping_ && pool->generation_ == seen_generation)
+			pthread_cond_wait(&pool->work_ready_, &pool->mutex_);
+		if (pool->stopping_)
+		{
+			pthread_mutex_unlock(&pool->mutex_);
+			break;
+		}
+		seen_generation = pool->generation_;
+		const function<void(int)> *task = pool->task_;
+		pthread_mutex_unlock(&pool->mutex_);
+
+		(*task)(worker->tid);
+
+		pthread_mutex_lock(&pool->mutex_);
+		if (--pool->pending_ == 0)
+			pthread_cond_signal(&pool->work_done_);
+		pthread_mutex_unlock(&pool->mutex_);
+	}
+
+	return NULL;
+}
@@ -0,0 +1,44 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <pthread.h>
+#include <functional>
+#include <vector>
+
+// Fixed set of long-lived pthreads that run one task on every thread at a time.
+// Creating the threads once and reusing them for every relaxation round and every
+// query removes the pthread_create/pthread_join cost from the solve path.
+class ThreadPool
+{
+public:
+	ThreadPool();
+	~ThreadPool();
+
+	void start(int num_threads);
+	void stop();
+	void run(const std::function<void(int)> &task);
+	int size() const { return num_threads_; }
+
+private:
+	static void *workerMain(void *arg);
+
+	struct WorkerArg
+	{
+		ThreadPool *pool;
+		int tid;
+		unsigned long long start_generation;
+	};
+
+	int num_threads_;
+	std::vector<pthread_t> threads_;
+	std::vector<WorkerArg> worker_args_;
+	pthread_mutex_t mutex_;
+	pthread_cond_t work_ready_;
+	pthread_cond_t work_done_;
+	const std::function<void(int)> *task_;
+	unsigned long long generation_;
+	int pending_;
+	bool stopping_;
+};
+
+#endif // THREAD_POOL_H